@@ -0,0 +1,48 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _BENCH_
+#define _BENCH_
+
+#include <time.h>
+#include <malloc.h>
+
+static inline double bench_ns(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Time stamp counter, 0 where there is none */
+static inline unsigned long long bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned int lo, hi;
+
+        __asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+        return ((unsigned long long)hi << 32) | lo;
+#else
+        return 0;
+#endif
+}
+
+/* Bytes of heap in use, counting the blocks malloc() maps on their own */
+static inline size_t bench_heap(void)
+{
+        struct mallinfo2 mi = mallinfo2();
+
+        return mi.uordblks + mi.hblkhd;
+}
+
+#endif //_BENCH_
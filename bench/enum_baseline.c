@@ -0,0 +1,156 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* EnumInstances() of HPI_LogicalDevice as it was before the inventory and
+ * the request arena, kept to measure them against. The debug printf()s of
+ * every property are left out, they would swamp everything else. */
+
+#include <stdio.h>
+#include <string.h>
+#include "cmpidt.h"
+#include "cmpift.h"
+#include "cmpimacs.h"
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include <hpi_utils.h>
+#include "enum_bench.h"
+
+static CMPIBroker * _BROKER;
+
+CMPIStatus baseline_enum_instances(CMPIResult * results, CMPIObjectPath * reference)
+{
+        /* HPI vars */
+        SaErrorT error;
+        SaHpiRptEntryT entry;
+        SaHpiEntryIdT entry_id = SAHPI_FIRST_ENTRY;
+
+        SaHpiEntryIdT rdr_id;
+        SaHpiRdrT     rdr;
+
+        oh_big_textbuffer bigbuf;
+
+        char buf[1024];
+
+        /* Commonly needed vars */
+        CMPIStatus status = {CMPI_RC_OK, NULL};	/* Return status of CIM operations */
+        CMPIInstance * instance;			/* CIM instance of each new instance of this class */
+        char * namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        char * classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        do {
+                error = saHpiRptEntryGet(hpi_hnd.sid, entry_id, &entry_id, &entry);
+                if (error != SA_OK) {
+                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+                }
+
+                rdr_id = SAHPI_FIRST_ENTRY;
+                do {
+                        memset(&rdr, 0, sizeof(rdr));
+                        error = saHpiRdrGet(hpi_hnd.sid, 
+                                            entry.ResourceId, 
+                                            rdr_id, 
+                                            &rdr_id, &rdr);
+
+                        instance = CMNewInstance(_BROKER, CMNewObjectPath(_BROKER, namespace, classname, &status), &status);
+                        if (status.rc != CMPI_RC_OK) {
+                                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+                        }
+
+                        CMSetProperty(instance, "RID", (CMPIValue *)&entry.ResourceId, CMPI_uint32);
+                        CMSetProperty(instance, "ElementName", (CMPIValue *)entry.ResourceTag.Data, CMPI_chars);
+
+                        SaHpiDomainInfoT domain_info;
+                        saHpiDomainInfoGet(hpi_hnd.sid, &domain_info);
+
+                        memset(buf, 0, sizeof(buf));
+                        sprintf(buf, "{Domain ID=%d}{Resource ID=%d}{Management Instrument Type=%s}{Management Instrument ID=%d}", 
+                                domain_info.DomainId,
+                                entry.ResourceId,
+                                oh_lookup_rdrtype(rdr.RdrType), 
+                                rdr.RecordId);
+                        CMSetProperty(instance, "DeviceID", 
+                                      (CMPIValue *)buf, CMPI_chars);
+
+                        CMSetProperty(instance, "SystemCreationClassName", (CMPIValue *)"Linux_ComputerSystem", CMPI_chars);
+                        CMSetProperty(instance, "SystemName", (CMPIValue *)"Laptop", CMPI_chars);
+                        CMSetProperty(instance, "CreationClassName", (CMPIValue *)"HPI_LogicalDevice", CMPI_chars);
+
+                        CMSetProperty(instance, "SID", (CMPIValue *)&hpi_hnd.sid, CMPI_uint32);
+                        CMSetProperty(instance, "DID", (CMPIValue *)&hpi_hnd.domain_info.DomainId, CMPI_uint32);
+                        CMSetProperty(instance, "RID", 
+                                      (CMPIValue *)&entry.ResourceId, CMPI_uint32);
+                        CMSetProperty(instance, "ResourceRev", 
+                                      (CMPIValue *)&entry.ResourceInfo.ResourceRev, 
+                                      CMPI_uint8);
+                        CMSetProperty(instance, "SpecificVer", 
+                                      (CMPIValue *)&entry.ResourceInfo.SpecificVer, 
+                                      CMPI_uint8);
+                        CMSetProperty(instance, "DeviceSupport", 
+                                      (CMPIValue *)&entry.ResourceInfo.DeviceSupport, 
+                                      CMPI_uint8);
+                        CMSetProperty(instance, "ManufacturerId", 
+                                      (CMPIValue *)&entry.ResourceInfo.ManufacturerId, 
+                                      CMPI_uint32);
+                        CMSetProperty(instance, "ProductId", 
+                                      (CMPIValue *)&entry.ResourceInfo.ProductId, 
+                                      CMPI_uint16);
+                        CMSetProperty(instance, "FirmwareMajorRev", 
+                                      (CMPIValue *)&entry.ResourceInfo.FirmwareMajorRev, 
+                                      CMPI_uint8);
+                        CMSetProperty(instance, "FirmwareMinorRev", 
+                                      (CMPIValue *)&entry.ResourceInfo.FirmwareMinorRev, 
+                                      CMPI_uint8);
+                        CMSetProperty(instance, "AuxFirmwareRev", 
+                                      (CMPIValue *)&entry.ResourceInfo.AuxFirmwareRev, 
+                                      CMPI_uint8);
+                        CMSetProperty(instance, "Guid", 
+                                      (CMPIValue *)&entry.ResourceInfo.Guid,
+                                      CMPI_chars);
+
+                        memset(&bigbuf, 0, sizeof(bigbuf));
+                        error = oh_decode_entitypath(&entry.ResourceEntity, &bigbuf);                        
+                        CMSetProperty(instance, "EntityPath", 
+                                      (CMPIValue *)bigbuf.Data, CMPI_chars);
+
+                        SaHpiTextBufferT buffer;
+                        memset(&buffer, 0, sizeof(buffer));
+                        error = oh_decode_capabilities(entry.ResourceCapabilities, 
+                                                       &buffer);
+                        CMSetProperty(instance, "Capabilities", 
+                                      (CMPIValue *)buffer.Data, CMPI_chars);
+
+                        memset(&buffer, 0, sizeof(buffer));
+                        error = oh_decode_hscapabilities(entry.HotSwapCapabilities,
+                                                 &buffer);
+                        CMSetProperty(instance, "HotSwapCapabilities", 
+                                      (CMPIValue *)buffer.Data, CMPI_chars);
+
+                        CMSetProperty(instance, "ResourceSeverity", 
+                                      (CMPIValue *)oh_lookup_severity(entry.ResourceSeverity), 
+                                      CMPI_chars);
+                        CMSetProperty(instance, "ResourceFailed", 
+                                      (CMPIValue *)((entry.ResourceFailed == SAHPI_TRUE) 
+                                                ? "TRUE" : "FALSE"), 
+                                      CMPI_chars);
+                        CMSetProperty(instance, "ResourceTag", 
+                                      (CMPIValue *)entry.ResourceTag.Data, CMPI_chars);
+
+                        CMReturnInstance(results, instance);
+
+                } while ( rdr_id != SAHPI_LAST_ENTRY );
+
+        } while (entry_id != SAHPI_LAST_ENTRY);
+
+        CMReturnDone(results);
+        return status;
+}
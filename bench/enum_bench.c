@@ -0,0 +1,194 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* Cost per instance of HPI_LogicalDevice EnumInstances(), run the same
+ * way on the same inventory with and without its capability decode
+ * tables, next to the loop it replaced (enum_baseline.c). The provider is
+ * compiled in whole to reach its static entry points, with two hooks on
+ * its arena calls: one to turn the tables off, one to read the arena's
+ * high-water mark before each request drops it.
+ *
+ * usage: enum_bench [resources [rdrs-per-resource [passes]]] */
+
+#include <hpi_arena.h>
+
+/* Set to leave the decode tables empty: every row then decodes its masks
+ * into the fixed spill buffer, as the loop did before the tables */
+static int per_row;
+
+/* Bytes the last request took from its arena, chunks included */
+static size_t arena_peak;
+
+static void arena_mark(struct hpi_arena *arena)
+{
+        struct hpi_arena_chunk *chunk;
+
+        if (arena->chunks == NULL) {
+                arena_peak = arena->used;
+                return;
+        }
+        /* Spilled: the caller's block and all but the newest chunk were used up */
+        arena_peak = arena->first_size + arena->used;
+        for (chunk = arena->chunks->next; chunk != NULL; chunk = chunk->next)
+                arena_peak += chunk->size;
+}
+
+#define hpi_arena_strndup(arena, str, len) \
+        (per_row ? NULL : hpi_arena_strndup(arena, str, len))
+#define hpi_arena_reset(arena) (arena_mark(arena), hpi_arena_reset(arena))
+
+#include "../src/Hpi.c"
+
+#include <stdio.h>
+#include "mock_hpi.h"
+#include "mock_cmpi.h"
+#include "enum_bench.h"
+#include "bench.h"
+
+/* Heap allocations made by the provider and the mocks, through the
+ * linker's --wrap of the allocator entry points */
+static unsigned long mallocs;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+char *__real_strdup(const char *s);
+
+void *__wrap_malloc(size_t size)
+{
+        mallocs++;
+        return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+        mallocs++;
+        return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+        mallocs++;
+        return __real_realloc(ptr, size);
+}
+
+char *__wrap_strdup(const char *s)
+{
+        mallocs++;
+        return __real_strdup(s);
+}
+
+struct run {
+        double          ns;
+        double          cycles;
+        double          mallocs;
+        double          hpi_calls;
+        double          broker_calls;
+        double          property_bytes;
+        size_t          arena_bytes;
+        unsigned long   instances;
+};
+
+static CMPIStatus current_enum_instances(CMPIResult *results, CMPIObjectPath *reference)
+{
+        return EnumInstances(NULL, NULL, results, reference, NULL);
+}
+
+/* Best of 'passes' enumerations */
+static int time_enum(CMPIStatus (*enumerate)(CMPIResult *, CMPIObjectPath *),
+                     CMPIObjectPath *reference, int passes, struct run *run)
+{
+        CMPIResult results;
+        unsigned long long cycles;
+        unsigned long hpi_calls, broker_calls, bytes, allocs;
+        CMPIStatus rc;
+        double t;
+        int i;
+
+        for (i = 0; i < passes; i++) {
+                memset(&results, 0, sizeof(results));
+                arena_peak = 0;
+                hpi_calls = mock.calls;
+                broker_calls = mock_cmpi_calls;
+                bytes = mock_cmpi_bytes;
+                allocs = mallocs;
+                cycles = bench_cycles();
+                t = bench_ns();
+                rc = enumerate(&results, reference);
+                t = bench_ns() - t;
+                cycles = bench_cycles() - cycles;
+                if (rc.rc != CMPI_RC_OK || !results.done || results.instances == 0)
+                        return -1;
+                if (i == 0 || t / results.instances < run->ns) {
+                        run->ns = t / results.instances;
+                        run->cycles = (double)cycles / results.instances;
+                }
+                run->instances = results.instances;
+                run->mallocs = (double)(mallocs - allocs) / results.instances;
+                run->hpi_calls = (double)(mock.calls - hpi_calls) / results.instances;
+                run->broker_calls = (double)(mock_cmpi_calls - broker_calls) / results.instances;
+                run->property_bytes = (double)(mock_cmpi_bytes - bytes) / results.instances;
+                run->arena_bytes = arena_peak;
+        }
+        return 0;
+}
+
+static void report(const char *what, const struct run *run)
+{
+        printf("%-26s %8.0f %11.0f %8zu %12.2f %9.2f %8.1f %7.1f\n", what, run->ns,
+               run->cycles, run->arena_bytes, run->mallocs, run->hpi_calls,
+               run->broker_calls, run->property_bytes);
+}
+
+int main(int argc, char **argv)
+{
+        unsigned int resources = argc > 1 ? atoi(argv[1]) : 1000;
+        unsigned int rdrs = argc > 2 ? atoi(argv[2]) : 10;
+        int passes = argc > 3 ? atoi(argv[3]) : 20;
+        struct run baseline, decode_per_row, decode_table;
+        CMPIObjectPath *reference;
+
+        mock_init(resources, rdrs);
+        if (hpi_session_open() != SA_OK || hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid)) {
+                fprintf(stderr, "no inventory\n");
+                return 1;
+        }
+        reference = CMNewObjectPath(NULL, "root/cimv2", _CLASSNAME, NULL);
+
+        per_row = 1;
+        if (time_enum(current_enum_instances, reference, passes, &decode_per_row)) {
+                fprintf(stderr, "enumeration failed\n");
+                return 1;
+        }
+        per_row = 0;
+        if (time_enum(current_enum_instances, reference, passes, &decode_table) ||
+            time_enum(baseline_enum_instances, reference, passes, &baseline) ||
+            baseline.instances != decode_table.instances ||
+            decode_per_row.instances != decode_table.instances) {
+                fprintf(stderr, "enumeration failed\n");
+                return 1;
+        }
+
+        printf("%u resources x %u RDRs = %lu instances, best of %d\n",
+               resources, rdrs, decode_table.instances, passes);
+        printf("%-26s %8s %11s %8s %12s %9s %8s %7s\n", "EnumInstances()", "ns/inst",
+               "cycles/inst", "arena B", "malloc/inst", "HPI/inst", "CM/inst", "prop B");
+        report("HPI loop, decode per row", &baseline);
+        report("inventory, decode per row", &decode_per_row);
+        report("inventory, decode tables", &decode_table);
+        printf("arena B: high-water mark of the request's arena\n"
+               "malloc/inst: allocator calls, the mock broker's instances included\n");
+
+        mock_release_object_path(reference);
+        return 0;
+}
@@ -0,0 +1,20 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _ENUM_BENCH_
+#define _ENUM_BENCH_
+
+#include "cmpidt.h"
+
+CMPIStatus baseline_enum_instances(CMPIResult *results, CMPIObjectPath *reference);
+
+#endif //_ENUM_BENCH_
@@ -0,0 +1,197 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* Memory footprint and scan speed of the columnar inventory against an
+ * array of the SaHpiRptEntryT and SaHpiRdrT structs HPI hands out.
+ *
+ * usage: inventory_bench [resources [rdrs-per-resource [passes]]] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include <hpi_utils.h>
+#include <hpi_inventory.h>
+#include "mock_hpi.h"
+#include "bench.h"
+
+/* What a cache of the HPI structs as they are keeps per RDR */
+struct naive_row {
+        SaHpiRptEntryT  rpt;
+        SaHpiRdrT       rdr;
+};
+
+struct naive_store {
+        struct naive_row *row;
+        unsigned int      count;
+        unsigned int      size;
+};
+
+/* Columns a provider reads for each instance */
+struct scan_sum {
+        unsigned long   rows;
+        unsigned long   sum;
+};
+
+static int naive_load(struct naive_store *s, SaHpiSessionIdT sid)
+{
+        SaHpiRptEntryT rpt;
+        SaHpiEntryIdT id, next, rdr_id, rdr_next;
+        struct naive_row *row;
+        unsigned int size;
+
+        for (id = SAHPI_FIRST_ENTRY; id != SAHPI_LAST_ENTRY; id = next) {
+                if (saHpiRptEntryGet(sid, id, &next, &rpt))
+                        return -1;
+                for (rdr_id = SAHPI_FIRST_ENTRY; rdr_id != SAHPI_LAST_ENTRY; rdr_id = rdr_next) {
+                        if (s->count == s->size) {
+                                size = s->size ? s->size * 2 : 64;
+                                row = realloc(s->row, size * sizeof(*row));
+                                if (row == NULL)
+                                        return -1;
+                                s->row = row;
+                                s->size = size;
+                        }
+                        row = &s->row[s->count];
+                        if (saHpiRdrGet(sid, rpt.ResourceId, rdr_id, &rdr_next, &row->rdr))
+                                break;
+                        row->rpt = rpt;
+                        s->count++;
+                }
+        }
+        return 0;
+}
+
+static void naive_scan(struct naive_store *s, struct scan_sum *sum)
+{
+        struct naive_row *row;
+        unsigned int i;
+
+        for (i = 0; i < s->count; i++) {
+                row = &s->row[i];
+                sum->rows++;
+                sum->sum += row->rpt.ResourceId + management_instrument_id(&row->rdr) +
+                            row->rdr.RdrType + row->rpt.ResourceCapabilities +
+                            row->rpt.HotSwapCapabilities + row->rpt.ResourceSeverity +
+                            row->rpt.ResourceFailed + row->rpt.ResourceTag.Data[0];
+        }
+}
+
+/* The same, decoding the entity path of each row as EnumInstances() does */
+static void naive_scan_decode(struct naive_store *s, struct scan_sum *sum)
+{
+        oh_big_textbuffer path;
+        unsigned int i;
+
+        naive_scan(s, sum);
+        for (i = 0; i < s->count; i++) {
+                oh_decode_entitypath(&s->row[i].rdr.Entity, &path);
+                sum->sum += path.DataLength;
+        }
+}
+
+static int columnar_row(void *data, int kind, const struct hpi_inv_row *row)
+{
+        struct scan_sum *sum = data;
+
+        sum->rows++;
+        sum->sum += row->rid + row->num + row->rdr_type + row->capabilities +
+                    row->hs_capabilities + row->severity + row->failed +
+                    (unsigned char)row->tag[0];
+        return 0;
+}
+
+static void columnar_scan(struct hpi_inventory *inv, struct scan_sum *sum)
+{
+        hpi_inventory_foreach(inv, columnar_row, sum);
+}
+
+/* Best time of 'passes' scans, in nanoseconds per row */
+static double time_scan(void (*scan)(void *, struct scan_sum *), void *store,
+                        int passes, struct scan_sum *sum)
+{
+        double t, best = 0;
+        int i;
+
+        for (i = 0; i < passes; i++) {
+                memset(sum, 0, sizeof(*sum));
+                t = bench_ns();
+                scan(store, sum);
+                t = bench_ns() - t;
+                if (i == 0 || t < best)
+                        best = t;
+        }
+        return sum->rows ? best / sum->rows : 0;
+}
+
+int main(int argc, char **argv)
+{
+        unsigned int resources = argc > 1 ? atoi(argv[1]) : 10000;
+        unsigned int rdrs = argc > 2 ? atoi(argv[2]) : 10;
+        int passes = argc > 3 ? atoi(argv[3]) : 20;
+        struct naive_store naive = { NULL, 0, 0 };
+        struct scan_sum col_sum, naive_sum, decode_sum;
+        size_t heap, col_bytes, naive_bytes;
+        double t, col_load, naive_load_ns, col_scan, naive_scan_ns, decode_scan;
+        SaHpiSessionIdT sid = 1;
+        unsigned long rows;
+
+        mock_init(resources, rdrs);
+        rows = (unsigned long)resources * rdrs;
+
+        heap = bench_heap();
+        t = bench_ns();
+        if (hpi_inventory_refresh(&hpi_inv, sid)) {
+                fprintf(stderr, "inventory refresh failed\n");
+                return 1;
+        }
+        col_load = bench_ns() - t;
+        col_bytes = bench_heap() - heap;
+
+        heap = bench_heap();
+        t = bench_ns();
+        if (naive_load(&naive, sid)) {
+                fprintf(stderr, "naive load failed\n");
+                return 1;
+        }
+        naive_load_ns = bench_ns() - t;
+        naive_bytes = bench_heap() - heap;
+
+        col_scan = time_scan((void (*)(void *, struct scan_sum *))columnar_scan,
+                             &hpi_inv, passes, &col_sum);
+        naive_scan_ns = time_scan((void (*)(void *, struct scan_sum *))naive_scan,
+                                  &naive, passes, &naive_sum);
+        decode_scan = time_scan((void (*)(void *, struct scan_sum *))naive_scan_decode,
+                                &naive, passes, &decode_sum);
+
+        if (col_sum.rows != rows || naive_sum.rows != rows || col_sum.sum != naive_sum.sum) {
+                fprintf(stderr, "stores differ: %lu/%lu rows, sums %lu/%lu\n",
+                        col_sum.rows, naive_sum.rows, col_sum.sum, naive_sum.sum);
+                return 1;
+        }
+
+        printf("%u resources x %u RDRs = %lu rows, sizeof(SaHpiRptEntryT) %zu, "
+               "sizeof(SaHpiRdrT) %zu\n", resources, rdrs, rows,
+               sizeof(SaHpiRptEntryT), sizeof(SaHpiRdrT));
+        printf("%-14s %12s %10s %10s %12s\n", "store", "heap bytes", "bytes/RDR",
+               "load ms", "scan ns/row");
+        printf("%-14s %12zu %10.1f %10.1f %12.2f\n", "columnar", col_bytes,
+               (double)col_bytes / rows, col_load / 1e6, col_scan);
+        printf("%-14s %12zu %10.1f %10.1f %12.2f\n", "naive", naive_bytes,
+               (double)naive_bytes / rows, naive_load_ns / 1e6, naive_scan_ns);
+        printf("%-14s %12s %10s %10s %12.2f\n", "naive+decode", "", "", "", decode_scan);
+
+        free(naive.row);
+        return 0;
+}
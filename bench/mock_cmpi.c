@@ -0,0 +1,300 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "cmpidt.h"
+#include "cmpift.h"
+#include "cmpimacs.h"
+#include "mock_cmpi.h"
+
+unsigned long mock_cmpi_calls;
+unsigned long mock_cmpi_bytes;
+
+static void status(CMPIStatus *rc, CMPIrc code)
+{
+        if (rc) {
+                rc->rc = code;
+                rc->msg = NULL;
+        }
+}
+
+static CMPIData null_data(void)
+{
+        CMPIData data;
+
+        memset(&data, 0, sizeof(data));
+        data.state = CMPI_nullValue;
+        return data;
+}
+
+char *CMGetCharPtr(CMPIString *str)
+{
+        return str->s;
+}
+
+CMPIObjectPath *CMNewObjectPath(CMPIBroker *broker, const char *ns, const char *cls,
+                                CMPIStatus *rc)
+{
+        CMPIObjectPath *op;
+
+        mock_cmpi_calls++;
+        op = calloc(1, sizeof(*op));
+        if (op == NULL) {
+                status(rc, CMPI_RC_ERR_FAILED);
+                return NULL;
+        }
+        op->name_space.s = strdup(ns ? ns : "");
+        op->class_name.s = strdup(cls ? cls : "");
+        status(rc, CMPI_RC_OK);
+        return op;
+}
+
+void mock_release_object_path(CMPIObjectPath *op)
+{
+        unsigned int i;
+
+        for (i = 0; i < op->count; i++) {
+                free(op->key_name[i].s);
+                if (op->key[i].type == CMPI_string) {
+                        free(op->key[i].value.string->s);
+                        free(op->key[i].value.string);
+                }
+        }
+        free(op->name_space.s);
+        free(op->class_name.s);
+        free(op);
+}
+
+CMPIString *CMGetNameSpace(CMPIObjectPath *op, CMPIStatus *rc)
+{
+        mock_cmpi_calls++;
+        status(rc, CMPI_RC_OK);
+        return &op->name_space;
+}
+
+CMPIString *CMGetClassName(CMPIObjectPath *op, CMPIStatus *rc)
+{
+        mock_cmpi_calls++;
+        status(rc, CMPI_RC_OK);
+        return &op->class_name;
+}
+
+/* CMPI_chars keys are stored as CMPI_string, as the brokers do */
+CMPIStatus CMAddKey(CMPIObjectPath *op, const char *name, CMPIValue *value, CMPIType type)
+{
+        CMPIStatus rc = { CMPI_RC_OK, NULL };
+        CMPIData *key;
+
+        mock_cmpi_calls++;
+        if (op->count == MOCK_CMPI_KEYS) {
+                rc.rc = CMPI_RC_ERR_FAILED;
+                return rc;
+        }
+        key = &op->key[op->count];
+        key->state = 0;
+        if (type == CMPI_chars || type == CMPI_string) {
+                key->type = CMPI_string;
+                key->value.string = malloc(sizeof(CMPIString));
+                key->value.string->s = strdup(type == CMPI_chars ?
+                                              (const char *)value :
+                                              value->string->s);
+        } else {
+                key->type = type;
+                key->value = *value;
+        }
+        op->key_name[op->count].s = strdup(name);
+        op->count++;
+        return rc;
+}
+
+unsigned CMGetKeyCount(CMPIObjectPath *op, CMPIStatus *rc)
+{
+        mock_cmpi_calls++;
+        status(rc, CMPI_RC_OK);
+        return op->count;
+}
+
+CMPIData CMGetKeyAt(CMPIObjectPath *op, unsigned index, CMPIString **name, CMPIStatus *rc)
+{
+        mock_cmpi_calls++;
+        if (index >= op->count) {
+                status(rc, CMPI_RC_ERR_NOT_FOUND);
+                return null_data();
+        }
+        if (name)
+                *name = &op->key_name[index];
+        status(rc, CMPI_RC_OK);
+        return op->key[index];
+}
+
+/* Key names are matched without regard to case, as in CIM */
+CMPIData CMGetKey(CMPIObjectPath *op, const char *name, CMPIStatus *rc)
+{
+        unsigned int i;
+
+        mock_cmpi_calls++;
+        for (i = 0; i < op->count; i++) {
+                if (strcasecmp(op->key_name[i].s, name) == 0) {
+                        status(rc, CMPI_RC_OK);
+                        return op->key[i];
+                }
+        }
+        status(rc, CMPI_RC_ERR_NOT_FOUND);
+        return null_data();
+}
+
+unsigned long long CMGetBinaryFormat(CMPIDateTime *dt, CMPIStatus *rc)
+{
+        mock_cmpi_calls++;
+        status(rc, CMPI_RC_OK);
+        return 0;
+}
+
+CMPIInstance *CMNewInstance(CMPIBroker *broker, CMPIObjectPath *op, CMPIStatus *rc)
+{
+        CMPIInstance *instance;
+
+        mock_cmpi_calls++;
+        instance = malloc(sizeof(*instance));
+        if (op == NULL || instance == NULL) {
+                free(instance);
+                status(rc, CMPI_RC_ERR_FAILED);
+                return NULL;
+        }
+        instance->op = op;
+        instance->properties = 0;
+        instance->used = 0;
+        status(rc, CMPI_RC_OK);
+        return instance;
+}
+
+static size_t value_size(CMPIValue *value, CMPIType type)
+{
+        switch (type) {
+        case CMPI_chars:        return strlen((const char *)value) + 1;
+        case CMPI_string:       return strlen(value->string->s) + 1;
+        case CMPI_boolean:
+        case CMPI_uint8:
+        case CMPI_sint8:        return 1;
+        case CMPI_char16:
+        case CMPI_uint16:
+        case CMPI_sint16:       return 2;
+        case CMPI_real32:
+        case CMPI_uint32:
+        case CMPI_sint32:       return 4;
+        default:                return 8;
+        }
+}
+
+CMPIStatus CMSetProperty(CMPIInstance *instance, const char *name, CMPIValue *value,
+                         CMPIType type)
+{
+        CMPIStatus rc = { CMPI_RC_OK, NULL };
+        const void *from = (type == CMPI_string) ? (void *)value->string->s : (void *)value;
+        size_t size = value_size(value, type);
+
+        mock_cmpi_calls++;
+        if (instance->used + size > sizeof(instance->data)) {
+                rc.rc = CMPI_RC_ERR_FAILED;
+                return rc;
+        }
+        memcpy(instance->data + instance->used, from, size);
+        instance->used += size;
+        instance->properties++;
+        mock_cmpi_bytes += size;
+        return rc;
+}
+
+/* The result takes the instance and its object path */
+CMPIStatus CMReturnInstance(CMPIResult *result, CMPIInstance *instance)
+{
+        CMPIStatus rc = { CMPI_RC_OK, NULL };
+
+        mock_cmpi_calls++;
+        result->instances++;
+        mock_release_object_path(instance->op);
+        free(instance);
+        return rc;
+}
+
+CMPIStatus CMReturnObjectPath(CMPIResult *result, CMPIObjectPath *op)
+{
+        CMPIStatus rc = { CMPI_RC_OK, NULL };
+
+        mock_cmpi_calls++;
+        result->object_paths++;
+        mock_release_object_path(op);
+        return rc;
+}
+
+CMPIStatus CMReturnData(CMPIResult *result, CMPIValue *value, CMPIType type)
+{
+        CMPIStatus rc = { CMPI_RC_OK, NULL };
+
+        mock_cmpi_calls++;
+        return rc;
+}
+
+CMPIStatus CMReturnDone(CMPIResult *result)
+{
+        CMPIStatus rc = { CMPI_RC_OK, NULL };
+
+        mock_cmpi_calls++;
+        result->done = 1;
+        return rc;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Not used by the benchmarks, present so whole providers link
+ * --------------------------------------------------------------------------- */
+
+CMPIString *CMNewString(CMPIBroker *broker, const char *chars, CMPIStatus *rc)
+{
+        status(rc, CMPI_RC_ERR_NOT_SUPPORTED);
+        return NULL;
+}
+
+CMPIArray *CMNewArray(CMPIBroker *broker, CMPICount count, CMPIType type, CMPIStatus *rc)
+{
+        status(rc, CMPI_RC_ERR_NOT_SUPPORTED);
+        return NULL;
+}
+
+CMPIStatus CMSetArrayElementAt(CMPIArray *array, CMPICount index, void *value, CMPIType type)
+{
+        CMPIStatus rc = { CMPI_RC_ERR_NOT_SUPPORTED, NULL };
+
+        return rc;
+}
+
+CMPICount CMGetArrayCount(CMPIArray *array, CMPIStatus *rc)
+{
+        status(rc, CMPI_RC_ERR_NOT_SUPPORTED);
+        return 0;
+}
+
+CMPIData CMGetArg(CMPIArgs *args, const char *name, CMPIStatus *rc)
+{
+        status(rc, CMPI_RC_ERR_NOT_FOUND);
+        return null_data();
+}
+
+CMPIStatus CMAddArg(CMPIArgs *args, const char *name, void *value, CMPIType type)
+{
+        CMPIStatus rc = { CMPI_RC_ERR_NOT_SUPPORTED, NULL };
+
+        return rc;
+}
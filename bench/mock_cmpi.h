@@ -0,0 +1,56 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _MOCK_CMPI_
+#define _MOCK_CMPI_
+
+#include "cmpidt.h"
+
+#define MOCK_CMPI_KEYS  8
+
+struct _CMPIString {
+        char           *s;
+};
+
+/* Keys are kept in the order they were added, strings are copied */
+struct _CMPIObjectPath {
+        CMPIString      name_space;
+        CMPIString      class_name;
+        unsigned int    count;
+        CMPIString      key_name[MOCK_CMPI_KEYS];
+        CMPIData        key[MOCK_CMPI_KEYS];
+};
+
+/* Property values are copied in, as a broker would */
+struct _CMPIInstance {
+        CMPIObjectPath *op;
+        unsigned int    properties;
+        unsigned int    used;
+        char            data[4096];
+};
+
+/* Counts what a provider returned */
+struct _CMPIResult {
+        unsigned long   instances;
+        unsigned long   object_paths;
+        int             done;
+};
+
+/* Broker calls served, the CMPI accessors on object paths included */
+extern unsigned long mock_cmpi_calls;
+
+/* Bytes of property values copied into instances */
+extern unsigned long mock_cmpi_bytes;
+
+void mock_release_object_path(CMPIObjectPath *op);
+
+#endif //_MOCK_CMPI_
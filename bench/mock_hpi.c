@@ -0,0 +1,327 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include "mock_hpi.h"
+
+#define SLOTS_PER_CHASSIS       16
+#define MOCK_ENT_BLADE          ((SaHpiEntityTypeT)0x10)  /* entity type of the blades */
+
+struct mock_domain mock;
+
+/* Instrument mix of each group of ten RDRs */
+static const SaHpiRdrTypeT kinds[10] = {
+        SAHPI_SENSOR_RDR, SAHPI_SENSOR_RDR, SAHPI_SENSOR_RDR,
+        SAHPI_SENSOR_RDR, SAHPI_SENSOR_RDR, SAHPI_SENSOR_RDR,
+        SAHPI_CTRL_RDR, SAHPI_CTRL_RDR,
+        SAHPI_INVENTORY_RDR, SAHPI_WATCHDOG_RDR
+};
+
+static void text(SaHpiTextBufferT *buf, const char *fmt, unsigned int n)
+{
+        buf->DataType = 0;
+        buf->Language = 0;
+        buf->DataLength = snprintf((char *)buf->Data, sizeof(buf->Data), fmt, n);
+}
+
+static void entity(SaHpiResourceIdT rid, SaHpiEntityPathT *ep)
+{
+        memset(ep, 0, sizeof(*ep));
+        ep->Entry[0].EntityType = MOCK_ENT_BLADE;
+        ep->Entry[0].EntityLocation = (rid - 1) % SLOTS_PER_CHASSIS;
+        ep->Entry[1].EntityType = SAHPI_ENT_SYSTEM_CHASSIS;
+        ep->Entry[1].EntityLocation = (rid - 1) / SLOTS_PER_CHASSIS;
+        ep->Entry[2].EntityType = SAHPI_ENT_ROOT;
+}
+
+void mock_init(unsigned int resources, unsigned int rdrs)
+{
+        mock.resources = resources;
+        mock.rdrs = rdrs;
+        mock.rpt_update_count = 1;
+        mock.calls = 0;
+}
+
+void mock_rpt_entry(SaHpiResourceIdT rid, SaHpiRptEntryT *entry)
+{
+        memset(entry, 0, sizeof(*entry));
+        entry->EntryId = rid;
+        entry->ResourceId = rid;
+        entry->ResourceInfo.ManufacturerId = 2;
+        entry->ResourceInfo.ProductId = rid % 7;
+        entity(rid, &entry->ResourceEntity);
+        entry->ResourceCapabilities = SAHPI_CAPABILITY_RESOURCE |
+                                      SAHPI_CAPABILITY_RDR |
+                                      SAHPI_CAPABILITY_SENSOR |
+                                      SAHPI_CAPABILITY_INVENTORY_DATA;
+        if (rid % 64 == 0)
+                entry->ResourceCapabilities |= SAHPI_CAPABILITY_EVENT_LOG;
+        entry->HotSwapCapabilities = (rid % 3) << 6;
+        entry->ResourceSeverity = (rid % 5 == 0) ? SAHPI_MAJOR : SAHPI_CRITICAL;
+        text(&entry->ResourceTag, "blade-%u", rid);
+}
+
+void mock_rdr(SaHpiResourceIdT rid, SaHpiEntryIdT id, SaHpiRdrT *rdr)
+{
+        memset(rdr, 0, sizeof(*rdr));
+        rdr->RecordId = id;
+        rdr->RdrType = kinds[id % 10];
+        entity(rid, &rdr->Entity);
+        switch (rdr->RdrType) {
+        case SAHPI_SENSOR_RDR:
+                rdr->RdrTypeUnion.SensorRec.Num = id;
+                rdr->RdrTypeUnion.SensorRec.Category = SAHPI_EC_THRESHOLD;
+                rdr->RdrTypeUnion.SensorRec.Events = 0x3f;
+                break;
+        case SAHPI_CTRL_RDR:
+                rdr->RdrTypeUnion.CtrlRec.Num = id;
+                break;
+        case SAHPI_INVENTORY_RDR:
+                rdr->RdrTypeUnion.InventoryRec.IdrId = id;
+                break;
+        case SAHPI_WATCHDOG_RDR:
+                rdr->RdrTypeUnion.WatchdogRec.WatchdogNum = id;
+                break;
+        default:
+                break;
+        }
+        text(&rdr->IdString, "rdr-%u", id);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * HPI
+ * --------------------------------------------------------------------------- */
+
+SaErrorT saHpiSessionOpen(SaHpiDomainIdT did, SaHpiSessionIdT *sid, void *security)
+{
+        *sid = 1;
+        return SA_OK;
+}
+
+SaErrorT saHpiSessionClose(SaHpiSessionIdT sid)
+{
+        return SA_OK;
+}
+
+SaErrorT saHpiDiscover(SaHpiSessionIdT sid)
+{
+        return SA_OK;
+}
+
+SaErrorT saHpiSubscribe(SaHpiSessionIdT sid)
+{
+        return SA_OK;
+}
+
+SaErrorT saHpiDomainInfoGet(SaHpiSessionIdT sid, SaHpiDomainInfoT *info)
+{
+        mock.calls++;
+        memset(info, 0, sizeof(*info));
+        info->DomainId = 1;
+        info->RptUpdateCount = mock.rpt_update_count;
+        text(&info->DomainTag, "domain-%u", 1);
+        return SA_OK;
+}
+
+SaErrorT saHpiRptEntryGet(SaHpiSessionIdT sid, SaHpiEntryIdT id,
+                          SaHpiEntryIdT *next, SaHpiRptEntryT *entry)
+{
+        SaHpiResourceIdT rid = (id == SAHPI_FIRST_ENTRY) ? 1 : id;
+
+        mock.calls++;
+        if (rid > mock.resources)
+                return SA_ERR_HPI_NOT_PRESENT;
+        mock_rpt_entry(rid, entry);
+        *next = (rid == mock.resources) ? SAHPI_LAST_ENTRY : rid + 1;
+        return SA_OK;
+}
+
+SaErrorT saHpiRptEntryGetByResourceId(SaHpiSessionIdT sid, SaHpiResourceIdT rid,
+                                      SaHpiRptEntryT *entry)
+{
+        mock.calls++;
+        if (rid == 0 || rid > mock.resources)
+                return SA_ERR_HPI_INVALID_RESOURCE;
+        mock_rpt_entry(rid, entry);
+        return SA_OK;
+}
+
+SaErrorT saHpiRdrGet(SaHpiSessionIdT sid, SaHpiResourceIdT rid, SaHpiEntryIdT id,
+                     SaHpiEntryIdT *next, SaHpiRdrT *rdr)
+{
+        mock.calls++;
+        if (rid == 0 || rid > mock.resources || id >= mock.rdrs)
+                return SA_ERR_HPI_NOT_PRESENT;
+        mock_rdr(rid, id, rdr);
+        *next = (id + 1 == mock.rdrs) ? SAHPI_LAST_ENTRY : id + 1;
+        return SA_OK;
+}
+
+SaErrorT saHpiEventGet(SaHpiSessionIdT sid, SaHpiTimeoutT timeout, SaHpiEventT *event,
+                       SaHpiRdrT *rdr, SaHpiRptEntryT *entry, SaHpiEvtQueueStatusT *status)
+{
+        mock.calls++;
+        return SA_ERR_HPI_TIMEOUT;
+}
+
+SaErrorT saHpiSensorReadingGet(SaHpiSessionIdT sid, SaHpiResourceIdT rid,
+                               SaHpiSensorNumT num, SaHpiSensorReadingT *reading,
+                               SaHpiEventStateT *state)
+{
+        mock.calls++;
+        if (reading)
+                memset(reading, 0, sizeof(*reading));
+        if (state)
+                *state = 0;
+        return SA_OK;
+}
+
+SaErrorT saHpiSensorEventMasksGet(SaHpiSessionIdT sid, SaHpiResourceIdT rid,
+                                  SaHpiSensorNumT num, SaHpiEventStateT *assert,
+                                  SaHpiEventStateT *deassert)
+{
+        mock.calls++;
+        if (assert)
+                *assert = 0x3f;
+        if (deassert)
+                *deassert = 0x3f;
+        return SA_OK;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * OPENHPI UTILITIES
+ * --------------------------------------------------------------------------- */
+
+static const char *entity_name(SaHpiEntityTypeT type)
+{
+        switch ((int)type) {
+        case SAHPI_ENT_SYSTEM_CHASSIS:  return "SYSTEM_CHASSIS";
+        case MOCK_ENT_BLADE:            return "BLADE";
+        default:                        return "UNSPECIFIED";
+        }
+}
+
+SaErrorT oh_decode_entitypath(const SaHpiEntityPathT *ep, oh_big_textbuffer *buf)
+{
+        int i, n = 0;
+
+        for (i = 0; i < SAHPI_MAX_ENTITY_PATH; i++)
+                if (ep->Entry[i].EntityType == SAHPI_ENT_ROOT)
+                        break;
+        while (i-- > 0)
+                n += snprintf((char *)buf->Data + n, sizeof(buf->Data) - n, "{%s,%u}",
+                              entity_name(ep->Entry[i].EntityType),
+                              ep->Entry[i].EntityLocation);
+        buf->DataLength = n;
+        return SA_OK;
+}
+
+/* Names of the set bits of 'mask', separated by " | " */
+static SaErrorT decode_mask(SaHpiUint32T mask, const char *const *names, int count,
+                            SaHpiTextBufferT *buf)
+{
+        int i, n = 0;
+
+        buf->Data[0] = '\0';
+        for (i = 0; i < count; i++) {
+                if (!(mask & (1U << i)) || names[i] == NULL)
+                        continue;
+                n += snprintf((char *)buf->Data + n, sizeof(buf->Data) - n, "%s%s",
+                              n ? " | " : "", names[i]);
+                if (n >= (int)sizeof(buf->Data))
+                        return SA_ERR_HPI_OUT_OF_SPACE;
+        }
+        buf->DataLength = n;
+        return SA_OK;
+}
+
+SaErrorT oh_decode_capabilities(SaHpiCapabilitiesT capabilities, SaHpiTextBufferT *buf)
+{
+        static const char *names[32] = {
+                [3] = "INVENTORY_DATA", [4] = "SENSOR", [9] = "RDR",
+                [17] = "EVENT_LOG", [30] = "RESOURCE"
+        };
+
+        return decode_mask(capabilities, names, 32, buf);
+}
+
+SaErrorT oh_decode_hscapabilities(SaHpiHsCapabilitiesT capabilities, SaHpiTextBufferT *buf)
+{
+        static const char *names[8] = {
+                [6] = "INDICATOR_SUPPORTED", [7] = "AUTOEXTRACT_READ_ONLY"
+        };
+
+        return decode_mask(capabilities, names, 8, buf);
+}
+
+/* Inverse of oh_decode_entitypath(), for the entity names it knows */
+SaErrorT oh_encode_entitypath(const char *str, SaHpiEntityPathT *ep)
+{
+        static const SaHpiEntityTypeT types[] = { SAHPI_ENT_SYSTEM_CHASSIS, MOCK_ENT_BLADE };
+        SaHpiEntityPathT path;
+        char name[32];
+        unsigned int location, t;
+        int i, n, count = 0;
+
+        memset(&path, 0, sizeof(path));
+        while (*str) {
+                if (count == SAHPI_MAX_ENTITY_PATH - 1 ||
+                    sscanf(str, "{%31[^,],%u}%n", name, &location, &n) != 2)
+                        return SA_ERR_HPI_INVALID_PARAMS;
+                for (t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+                        if (strcmp(name, entity_name(types[t])) == 0)
+                                break;
+                if (t == sizeof(types) / sizeof(types[0]))
+                        return SA_ERR_HPI_INVALID_PARAMS;
+                path.Entry[count].EntityType = types[t];
+                path.Entry[count].EntityLocation = location;
+                count++;
+                str += n;
+        }
+
+        /* The string lists the outermost entity first */
+        memset(ep, 0, sizeof(*ep));
+        for (i = 0; i < count; i++)
+                ep->Entry[i] = path.Entry[count - 1 - i];
+        ep->Entry[count].EntityType = SAHPI_ENT_ROOT;
+        return SA_OK;
+}
+
+const char *oh_lookup_rdrtype(SaHpiRdrTypeT type)
+{
+        static const char *names[] = {
+                "NO_RECORD", "CTRL_RDR", "SENSOR_RDR", "INVENTORY_RDR",
+                "WATCHDOG_RDR", "ANNUNCIATOR_RDR"
+        };
+
+        return (unsigned int)type <= SAHPI_ANNUNCIATOR_RDR ? names[type] : NULL;
+}
+
+const char *oh_lookup_severity(SaHpiSeverityT severity)
+{
+        switch (severity) {
+        case SAHPI_CRITICAL:            return "CRITICAL";
+        case SAHPI_MAJOR:               return "MAJOR";
+        case SAHPI_MINOR:               return "MINOR";
+        case SAHPI_INFORMATIONAL:       return "INFORMATIONAL";
+        case SAHPI_OK:                  return "OK";
+        case SAHPI_DEBUG:               return "DEBUG";
+        case SAHPI_ALL_SEVERITIES:      return "ALL_SEVERITIES";
+        default:                        return NULL;
+        }
+}
@@ -0,0 +1,33 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _MOCK_HPI_
+#define _MOCK_HPI_
+
+#include <SaHpi.h>
+
+/* Synthetic domain served by mock_hpi.c: 'resources' blades, sixteen to a
+ * chassis, each with 'rdrs' instruments. Resource ids start at 1. */
+struct mock_domain {
+        unsigned int    resources;
+        unsigned int    rdrs;
+        SaHpiUint32T    rpt_update_count;
+        unsigned long   calls;          /* saHpi*() calls served */
+};
+
+extern struct mock_domain mock;
+
+void mock_init(unsigned int resources, unsigned int rdrs);
+void mock_rpt_entry(SaHpiResourceIdT rid, SaHpiRptEntryT *entry);
+void mock_rdr(SaHpiResourceIdT rid, SaHpiEntryIdT id, SaHpiRdrT *rdr);
+
+#endif //_MOCK_HPI_
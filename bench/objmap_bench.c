@@ -0,0 +1,219 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* Object path lookup and de-duplication by fingerprint map against the
+ * pairwise _CMSameObject() scan it replaces, over N synthetic
+ * HPI_LogicalDevice paths.
+ *
+ * usage: objmap_bench [N ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cmpidt.h"
+#include "cmpift.h"
+#include "cmpimacs.h"
+#include "utils.h"
+#include "mock_cmpi.h"
+#include "bench.h"
+
+struct result {
+        double          ns;             /* per operation */
+        double          calls;          /* broker calls per operation */
+        unsigned int    found;
+};
+
+/* The keys EnumInstanceNames() gives an instrument, in its order, or
+ * reversed and with the names in another case as a client may send them */
+static CMPIObjectPath *device_path(unsigned int i, int reversed)
+{
+        static const char *names[2][4] = {
+                { "DeviceID", "SystemCreationClassName", "SystemName", "CreationClassName" },
+                { "CREATIONCLASSNAME", "systemname", "SYSTEMCREATIONCLASSNAME", "deviceid" }
+        };
+        const char *value[4];
+        CMPIObjectPath *op;
+        char id[160];
+        int k;
+
+        /* As hpi_device_id() builds it, ten instruments per resource */
+        snprintf(id, sizeof(id),
+                 "{Domain ID=1}{Resource ID=%u}{Management Instrument Type=SENSOR_RDR}"
+                 "{Management Instrument ID=%u}", i / 10 + 1, i % 10);
+        value[0] = id;
+        value[1] = "Linux_ComputerSystem";
+        value[2] = "Laptop";
+        value[3] = "HPI_LogicalDevice";
+
+        op = CMNewObjectPath(NULL, "root/cimv2", "HPI_LogicalDevice", NULL);
+        for (k = 0; k < 4; k++)
+                CMAddKey(op, names[reversed][k],
+                         (CMPIValue *)value[reversed ? 3 - k : k], CMPI_chars);
+        return op;
+}
+
+static CMPIObjectPath **device_paths(unsigned int n, int reversed)
+{
+        CMPIObjectPath **op = malloc(n * sizeof(*op));
+        unsigned int i;
+
+        for (i = 0; i < n; i++)
+                op[i] = device_path(i, reversed);
+        return op;
+}
+
+static void release_paths(CMPIObjectPath **op, unsigned int n)
+{
+        unsigned int i;
+
+        for (i = 0; i < n; i++)
+                mock_release_object_path(op[i]);
+        free(op);
+}
+
+/* Find each of 'query' among 'cached', in a different order */
+static void lookup_pairwise(CMPIObjectPath **cached, CMPIObjectPath **query,
+                            unsigned int n, struct result *r)
+{
+        unsigned int i, j, q;
+        double t;
+
+        mock_cmpi_calls = 0;
+        r->found = 0;
+        t = bench_ns();
+        for (i = 0; i < n; i++) {
+                q = (i * 7919) % n;
+                for (j = 0; j < n; j++) {
+                        if (_CMSameObject(cached[j], query[q])) {
+                                r->found++;
+                                break;
+                        }
+                }
+        }
+        r->ns = (bench_ns() - t) / n;
+        r->calls = (double)mock_cmpi_calls / n;
+}
+
+static void lookup_map(CMPIObjectPath **cached, CMPIObjectPath **query,
+                       unsigned int n, struct result *r)
+{
+        CMObjectMap *map = _CMNewObjectMap();
+        unsigned int i;
+        double t;
+
+        for (i = 0; i < n; i++)
+                _CMObjectMapAdd(map, cached[i], NULL);
+
+        mock_cmpi_calls = 0;
+        r->found = 0;
+        t = bench_ns();
+        for (i = 0; i < n; i++)
+                if (_CMObjectMapFind(map, query[(i * 7919) % n]))
+                        r->found++;
+        r->ns = (bench_ns() - t) / n;
+        r->calls = (double)mock_cmpi_calls / n;
+        _CMReleaseObjectMap(map);
+}
+
+/* Keep the first of each object among the paths of both lists, met
+ * alternately, as when merging two enumerations */
+static void dedup_pairwise(CMPIObjectPath **a, CMPIObjectPath **b,
+                           unsigned int n, struct result *r)
+{
+        CMPIObjectPath **kept = malloc(n * sizeof(*kept)), *op;
+        unsigned int i, j;
+        double t;
+
+        mock_cmpi_calls = 0;
+        r->found = 0;
+        t = bench_ns();
+        for (i = 0; i < 2 * n; i++) {
+                op = (i & 1) ? b[(i / 2 * 7919) % n] : a[i / 2];
+                for (j = 0; j < r->found; j++)
+                        if (_CMSameObject(kept[j], op))
+                                break;
+                if (j == r->found)
+                        kept[r->found++] = op;
+        }
+        r->ns = (bench_ns() - t) / (2 * n);
+        r->calls = (double)mock_cmpi_calls / (2 * n);
+        free(kept);
+}
+
+static void dedup_map(CMPIObjectPath **a, CMPIObjectPath **b,
+                      unsigned int n, struct result *r)
+{
+        CMObjectMap *map = _CMNewObjectMap();
+        CMPIObjectPath *op;
+        unsigned int i;
+        double t;
+
+        mock_cmpi_calls = 0;
+        r->found = 0;
+        t = bench_ns();
+        for (i = 0; i < 2 * n; i++) {
+                op = (i & 1) ? b[(i / 2 * 7919) % n] : a[i / 2];
+                if (_CMObjectMapAdd(map, op, NULL) == 1)
+                        r->found++;
+        }
+        r->ns = (bench_ns() - t) / (2 * n);
+        r->calls = (double)mock_cmpi_calls / (2 * n);
+        _CMReleaseObjectMap(map);
+}
+
+static void report(const char *what, unsigned int n, const struct result *r)
+{
+        printf("%-16s %7u %12.1f %12.1f\n", what, n, r->ns, r->calls);
+}
+
+int main(int argc, char **argv)
+{
+        static const unsigned int sizes[] = { 100, 1000, 10000 };
+        CMPIObjectPath **a, **b;
+        struct result pairwise, map;
+        unsigned int n;
+        int i, count = argc > 1 ? argc - 1 : 3;
+
+        printf("%-16s %7s %12s %12s\n", "operation", "N", "ns/op", "calls/op");
+        for (i = 0; i < count; i++) {
+                n = argc > 1 ? (unsigned int)atoi(argv[i + 1]) : sizes[i];
+                if (n == 0)
+                        continue;
+                a = device_paths(n, 0);
+                b = device_paths(n, 1);
+
+                lookup_pairwise(a, b, n, &pairwise);
+                lookup_map(a, b, n, &map);
+                if (pairwise.found != n || map.found != n) {
+                        fprintf(stderr, "lookup found %u/%u of %u\n",
+                                pairwise.found, map.found, n);
+                        return 1;
+                }
+                report("lookup pairwise", n, &pairwise);
+                report("lookup map", n, &map);
+
+                dedup_pairwise(a, b, n, &pairwise);
+                dedup_map(a, b, n, &map);
+                if (pairwise.found != n || map.found != n) {
+                        fprintf(stderr, "dedup kept %u/%u of %u\n",
+                                pairwise.found, map.found, n);
+                        return 1;
+                }
+                report("dedup pairwise", n, &pairwise);
+                report("dedup map", n, &map);
+
+                release_paths(a, n);
+                release_paths(b, n);
+        }
+        return 0;
+}
@@ -0,0 +1,18 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* Tracing from the cmpiOSBase_Common library, compiled out */
+#ifndef OSBASE_COMMON_STUB
+#define OSBASE_COMMON_STUB
+#define _OSBASE_TRACE(LEVEL,STR)
+#endif
@@ -0,0 +1,117 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* The part of the HPI B.01.01 SaHpi.h the benchmarks build against, so they
+ * need neither OpenHPI nor a daemon. The record unions keep the members that
+ * decide their size in the real header, so sizeof(SaHpiRdrT) and
+ * sizeof(SaHpiRptEntryT) come out close to what the providers copy. */
+#ifndef SAHPI_STUB
+#define SAHPI_STUB
+#include <stdint.h>
+typedef uint8_t SaHpiUint8T; typedef uint16_t SaHpiUint16T; typedef uint32_t SaHpiUint32T; typedef uint64_t SaHpiUint64T;
+typedef int8_t SaHpiInt8T; typedef int32_t SaHpiInt32T; typedef int64_t SaHpiInt64T;
+typedef SaHpiUint8T SaHpiBoolT; typedef SaHpiInt32T SaErrorT; typedef SaHpiUint32T SaHpiSessionIdT, SaHpiDomainIdT, SaHpiResourceIdT, SaHpiEntryIdT, SaHpiInstrumentIdT, SaHpiSensorNumT, SaHpiIdrIdT, SaHpiCapabilitiesT, SaHpiEventLogEntryIdT, SaHpiManufacturerIdT, SaHpiAlarmIdT;
+typedef SaHpiUint8T SaHpiHsCapabilitiesT; typedef SaHpiInt64T SaHpiTimeT, SaHpiTimeoutT; typedef SaHpiUint8T SaHpiGuidT[16]; typedef SaHpiUint16T SaHpiEventStateT; typedef SaHpiUint32T SaHpiEvtQueueStatusT;
+#define SA_OK 0
+#define SA_ERR_HPI_NOT_PRESENT (-1006)
+#define SA_ERR_HPI_TIMEOUT (-1009)
+#define SA_ERR_HPI_INVALID_PARAMS (-1002)
+#define SA_ERR_HPI_OUT_OF_SPACE (-1007)
+#define SA_ERR_HPI_OUT_OF_MEMORY (-1008)
+#define SA_ERR_HPI_INVALID_RESOURCE (-1016)
+#define SA_ERR_HPI_CAPABILITY (-1020)
+#define SAHPI_TRUE 1
+#define SAHPI_FALSE 0
+#define SAHPI_FIRST_ENTRY 0
+#define SAHPI_LAST_ENTRY 0xFFFFFFFF
+#define SAHPI_OLDEST_ENTRY 0
+#define SAHPI_NEWEST_ENTRY 0xFFFFFFFF
+#define SAHPI_NO_MORE_ENTRIES 0xFFFFFFFE
+#define SAHPI_UNSPECIFIED_DOMAIN_ID 0xFFFFFFFF
+#define SAHPI_UNSPECIFIED_RESOURCE_ID 0xFFFFFFFF
+#define SAHPI_TIMEOUT_IMMEDIATE 0
+#define SAHPI_EVT_QUEUE_OVERFLOW (SaHpiEvtQueueStatusT)0x0001
+#define SAHPI_MAX_ENTITY_PATH 16
+#define SAHPI_MAX_TEXT_BUFFER_LENGTH 255
+#define SAHPI_CAPABILITY_RESOURCE 0x40000000
+#define SAHPI_CAPABILITY_EVENT_LOG 0x00020000
+#define SAHPI_CAPABILITY_INVENTORY_DATA 0x00000008
+#define SAHPI_CAPABILITY_RDR 0x00000200
+#define SAHPI_CAPABILITY_SENSOR 0x00000010
+typedef enum { SAHPI_NO_RECORD, SAHPI_CTRL_RDR, SAHPI_SENSOR_RDR, SAHPI_INVENTORY_RDR, SAHPI_WATCHDOG_RDR, SAHPI_ANNUNCIATOR_RDR } SaHpiRdrTypeT;
+typedef enum { SAHPI_CRITICAL=0, SAHPI_MAJOR, SAHPI_MINOR, SAHPI_INFORMATIONAL, SAHPI_OK, SAHPI_DEBUG=0xF0, SAHPI_ALL_SEVERITIES=0xFF } SaHpiSeverityT;
+typedef enum { SAHPI_ENT_UNSPECIFIED=0, SAHPI_ENT_SYSTEM_CHASSIS=23, SAHPI_ENT_ROOT=65535 } SaHpiEntityTypeT;
+typedef SaHpiUint32T SaHpiEntityLocationT;
+typedef struct { SaHpiEntityTypeT EntityType; SaHpiEntityLocationT EntityLocation; } SaHpiEntityT;
+typedef struct { SaHpiEntityT Entry[SAHPI_MAX_ENTITY_PATH]; } SaHpiEntityPathT;
+typedef struct { SaHpiUint8T DataType; SaHpiUint8T Language; SaHpiUint8T DataLength; SaHpiUint8T Data[SAHPI_MAX_TEXT_BUFFER_LENGTH]; } SaHpiTextBufferT;
+typedef struct { SaHpiUint8T ResourceRev, SpecificVer, DeviceSupport; SaHpiManufacturerIdT ManufacturerId; SaHpiUint16T ProductId; SaHpiUint8T FirmwareMajorRev, FirmwareMinorRev, AuxFirmwareRev; SaHpiGuidT Guid; } SaHpiResourceInfoT;
+typedef struct { SaHpiEntryIdT EntryId; SaHpiResourceIdT ResourceId; SaHpiResourceInfoT ResourceInfo; SaHpiEntityPathT ResourceEntity; SaHpiCapabilitiesT ResourceCapabilities; SaHpiHsCapabilitiesT HotSwapCapabilities; SaHpiSeverityT ResourceSeverity; SaHpiBoolT ResourceFailed; SaHpiTextBufferT ResourceTag; } SaHpiRptEntryT;
+typedef SaHpiUint8T SaHpiEventCategoryT;
+#define SAHPI_EC_THRESHOLD (SaHpiEventCategoryT)0x01
+#define SAHPI_ES_LOWER_MINOR (SaHpiEventStateT)0x0001
+#define SAHPI_ES_LOWER_MAJOR (SaHpiEventStateT)0x0002
+#define SAHPI_ES_LOWER_CRIT (SaHpiEventStateT)0x0004
+#define SAHPI_ES_UPPER_MINOR (SaHpiEventStateT)0x0008
+#define SAHPI_ES_UPPER_MAJOR (SaHpiEventStateT)0x0010
+#define SAHPI_ES_UPPER_CRIT (SaHpiEventStateT)0x0020
+typedef union { SaHpiInt64T SensorInt64; double SensorFloat64; SaHpiUint8T SensorBuffer[32]; } SaHpiSensorReadingUnionT;
+typedef struct { SaHpiBoolT IsSupported; SaHpiUint32T Type; SaHpiSensorReadingUnionT Value; } SaHpiSensorReadingT;
+typedef struct { SaHpiUint8T Flags; SaHpiSensorReadingT Max, Min, Nominal, NormalMax, NormalMin; } SaHpiSensorRangeT;
+typedef struct { SaHpiBoolT IsSupported; SaHpiUint32T ReadingType, BaseUnits, ModifierUnits, ModifierUse; SaHpiBoolT Percentage; SaHpiSensorRangeT Range; double AccuracyFactor; } SaHpiSensorDataFormatT;
+typedef struct { SaHpiBoolT IsAccessible; SaHpiUint8T ReadThold, WriteThold; SaHpiBoolT Nonlinear; } SaHpiSensorThdDefnT;
+typedef struct { SaHpiSensorNumT Num; SaHpiUint32T Type; SaHpiEventCategoryT Category; SaHpiBoolT EnableCtrl; SaHpiUint32T EventCtrl; SaHpiEventStateT Events; SaHpiSensorDataFormatT DataFormat; SaHpiSensorThdDefnT ThresholdDefn; SaHpiUint32T Oem; } SaHpiSensorRecT;
+typedef struct { SaHpiManufacturerIdT MId; SaHpiUint8T BodyLength; SaHpiUint8T Body[255]; } SaHpiCtrlStateOemT;
+typedef struct { SaHpiManufacturerIdT MId; SaHpiUint8T ConfigData[10]; SaHpiCtrlStateOemT Default; } SaHpiCtrlRecOemT;
+typedef struct { SaHpiUint32T Mode; SaHpiBoolT ReadOnly; } SaHpiCtrlDefaultModeT;
+typedef struct { SaHpiUint32T Num; SaHpiUint32T OutputType; SaHpiUint32T Type; union { SaHpiCtrlRecOemT Oem; } TypeUnion; SaHpiCtrlDefaultModeT DefaultMode; SaHpiBoolT WriteOnly; SaHpiUint32T Oem; } SaHpiCtrlRecT;
+typedef struct { SaHpiIdrIdT IdrId; SaHpiBoolT Persistent; SaHpiUint32T Oem; } SaHpiInventoryRecT;
+typedef struct { SaHpiUint32T WatchdogNum; SaHpiUint32T Oem; } SaHpiWatchdogRecT;
+typedef struct { SaHpiUint32T AnnunciatorNum; SaHpiUint32T AnnunciatorType; SaHpiBoolT ModeReadOnly; SaHpiUint32T MaxConditions; SaHpiUint32T Oem; } SaHpiAnnunciatorRecT;
+typedef union { SaHpiCtrlRecT CtrlRec; SaHpiSensorRecT SensorRec; SaHpiInventoryRecT InventoryRec; SaHpiWatchdogRecT WatchdogRec; SaHpiAnnunciatorRecT AnnunciatorRec; } SaHpiRdrTypeUnionT;
+typedef struct { SaHpiEntryIdT RecordId; SaHpiRdrTypeT RdrType; SaHpiEntityPathT Entity; SaHpiBoolT IsFru; SaHpiRdrTypeUnionT RdrTypeUnion; SaHpiTextBufferT IdString; } SaHpiRdrT;
+typedef struct { SaHpiDomainIdT DomainId; SaHpiUint32T DomainCapabilities; SaHpiBoolT IsPeer; SaHpiTextBufferT DomainTag; SaHpiUint32T DrtUpdateCount; SaHpiTimeT DrtUpdateTimestamp; SaHpiUint32T RptUpdateCount; SaHpiTimeT RptUpdateTimestamp; SaHpiUint32T DatUpdateCount; SaHpiTimeT DatUpdateTimestamp; SaHpiUint32T ActiveAlarms, CriticalAlarms, MajorAlarms, MinorAlarms, DatUserAlarmLimit; SaHpiBoolT DatOverflow; SaHpiGuidT Guid; } SaHpiDomainInfoT;
+typedef enum { SAHPI_ET_RESOURCE, SAHPI_ET_DOMAIN, SAHPI_ET_SENSOR, SAHPI_ET_SENSOR_ENABLE_CHANGE, SAHPI_ET_HOTSWAP, SAHPI_ET_WATCHDOG, SAHPI_ET_HPI_SW, SAHPI_ET_OEM, SAHPI_ET_USER } SaHpiEventTypeT;
+typedef enum { SAHPI_RESE_RESOURCE_FAILURE, SAHPI_RESE_RESOURCE_RESTORED, SAHPI_RESE_RESOURCE_ADDED } SaHpiResourceEventTypeT;
+typedef enum { SAHPI_HS_STATE_INACTIVE, SAHPI_HS_STATE_INSERTION_PENDING, SAHPI_HS_STATE_ACTIVE, SAHPI_HS_STATE_EXTRACTION_PENDING, SAHPI_HS_STATE_NOT_PRESENT } SaHpiHsStateT;
+typedef struct { SaHpiResourceEventTypeT ResourceEventType; } SaHpiResourceEventT;
+typedef struct { SaHpiSensorNumT SensorNum; SaHpiUint8T SensorType; SaHpiUint8T EventCategory; SaHpiBoolT Assertion; SaHpiEventStateT EventState; } SaHpiSensorEventT;
+typedef struct { SaHpiSensorNumT SensorNum; } SaHpiSensorEnableChangeEventT;
+typedef struct { SaHpiHsStateT HotSwapState; SaHpiHsStateT PreviousHotSwapState; } SaHpiHotSwapEventT;
+typedef union { SaHpiResourceEventT ResourceEvent; SaHpiSensorEventT SensorEvent; SaHpiSensorEnableChangeEventT SensorEnableChangeEvent; SaHpiHotSwapEventT HotSwapEvent; } SaHpiEventUnionT;
+typedef struct { SaHpiResourceIdT Source; SaHpiEventTypeT EventType; SaHpiTimeT Timestamp; SaHpiSeverityT Severity; SaHpiEventUnionT EventDataUnion; } SaHpiEventT;
+typedef struct { SaHpiEventLogEntryIdT EntryId; SaHpiTimeT Timestamp; SaHpiEventT Event; } SaHpiEventLogEntryT;
+typedef struct { SaHpiUint32T Entries, Size, UserEventMaxSize; SaHpiTimeT UpdateTimestamp, CurrentTime; SaHpiBoolT Enabled, OverflowFlag, OverflowResetable; SaHpiUint32T OverflowAction; } SaHpiEventLogInfoT;
+typedef struct { SaHpiIdrIdT IdrId; SaHpiUint32T UpdateCount; SaHpiBoolT ReadOnly; SaHpiUint32T NumAreas; } SaHpiIdrInfoT;
+typedef enum { SAHPI_IDR_AREATYPE_INTERNAL_USE=0xB0, SAHPI_IDR_AREATYPE_CHASSIS_INFO, SAHPI_IDR_AREATYPE_BOARD_INFO, SAHPI_IDR_AREATYPE_PRODUCT_INFO, SAHPI_IDR_AREATYPE_OEM=0xC0, SAHPI_IDR_AREATYPE_UNSPECIFIED=0xFF } SaHpiIdrAreaTypeT;
+typedef enum { SAHPI_IDR_FIELDTYPE_CHASSIS_TYPE, SAHPI_IDR_FIELDTYPE_MFG_DATETIME, SAHPI_IDR_FIELDTYPE_MANUFACTURER, SAHPI_IDR_FIELDTYPE_PRODUCT_NAME, SAHPI_IDR_FIELDTYPE_PRODUCT_VERSION, SAHPI_IDR_FIELDTYPE_SERIAL_NUMBER, SAHPI_IDR_FIELDTYPE_PART_NUMBER, SAHPI_IDR_FIELDTYPE_FILE_ID, SAHPI_IDR_FIELDTYPE_ASSET_TAG, SAHPI_IDR_FIELDTYPE_CUSTOM, SAHPI_IDR_FIELDTYPE_UNSPECIFIED=0xFF } SaHpiIdrFieldTypeT;
+typedef struct { SaHpiEntryIdT AreaId; SaHpiIdrAreaTypeT Type; SaHpiBoolT ReadOnly; SaHpiUint32T NumFields; } SaHpiIdrAreaHeaderT;
+typedef struct { SaHpiEntryIdT AreaId; SaHpiEntryIdT FieldId; SaHpiIdrFieldTypeT Type; SaHpiBoolT ReadOnly; SaHpiTextBufferT Field; } SaHpiIdrFieldT;
+SaErrorT saHpiSessionOpen(SaHpiDomainIdT, SaHpiSessionIdT*, void*);
+SaErrorT saHpiSessionClose(SaHpiSessionIdT);
+SaErrorT saHpiDiscover(SaHpiSessionIdT);
+SaErrorT saHpiSubscribe(SaHpiSessionIdT);
+SaErrorT saHpiUnsubscribe(SaHpiSessionIdT);
+SaErrorT saHpiDomainInfoGet(SaHpiSessionIdT, SaHpiDomainInfoT*);
+SaErrorT saHpiRptEntryGet(SaHpiSessionIdT, SaHpiEntryIdT, SaHpiEntryIdT*, SaHpiRptEntryT*);
+SaErrorT saHpiRptEntryGetByResourceId(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiRptEntryT*);
+SaErrorT saHpiRdrGet(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiEntryIdT, SaHpiEntryIdT*, SaHpiRdrT*);
+SaErrorT saHpiEventGet(SaHpiSessionIdT, SaHpiTimeoutT, SaHpiEventT*, SaHpiRdrT*, SaHpiRptEntryT*, SaHpiEvtQueueStatusT*);
+SaErrorT saHpiEventLogInfoGet(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiEventLogInfoT*);
+SaErrorT saHpiEventLogEntryGet(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiEventLogEntryIdT, SaHpiEventLogEntryIdT*, SaHpiEventLogEntryIdT*, SaHpiEventLogEntryT*, SaHpiRdrT*, SaHpiRptEntryT*);
+SaErrorT saHpiIdrInfoGet(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiIdrIdT, SaHpiIdrInfoT*);
+SaErrorT saHpiIdrAreaHeaderGet(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiIdrIdT, SaHpiIdrAreaTypeT, SaHpiEntryIdT, SaHpiEntryIdT*, SaHpiIdrAreaHeaderT*);
+SaErrorT saHpiIdrFieldGet(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiIdrIdT, SaHpiEntryIdT, SaHpiIdrFieldTypeT, SaHpiEntryIdT, SaHpiEntryIdT*, SaHpiIdrFieldT*);
+SaErrorT saHpiSensorReadingGet(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiSensorNumT, SaHpiSensorReadingT*, SaHpiEventStateT*);
+SaErrorT saHpiSensorEventMasksGet(SaHpiSessionIdT, SaHpiResourceIdT, SaHpiSensorNumT, SaHpiEventStateT*, SaHpiEventStateT*);
+#endif
@@ -0,0 +1,50 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* The CMPI 0.90 data types the providers use. Objects are opaque here;
+ * mock_cmpi.c gives them the little state the benchmarks need. */
+#ifndef CMPIDT_STUB
+#define CMPIDT_STUB
+#include <stddef.h>
+typedef unsigned char CMPIBoolean; typedef unsigned int CMPIUint32; typedef unsigned short CMPIType, CMPIValueState; typedef unsigned int CMPICount;
+typedef enum { CMPI_RC_OK=0, CMPI_RC_ERR_FAILED=1, CMPI_RC_ERR_INVALID_PARAMETER=4, CMPI_RC_ERR_NOT_FOUND=6, CMPI_RC_ERR_NOT_SUPPORTED=7, CMPI_RC_ERR_INVALID_QUERY=15, CMPI_RC_ERR_METHOD_NOT_FOUND=17, CMPI_RC_ERR_QUERY_LANGUAGE_NOT_SUPPORTED=14 } CMPIrc;
+typedef struct _CMPIString CMPIString; typedef struct _CMPIBroker CMPIBroker; typedef struct _CMPIContext CMPIContext; typedef struct _CMPIResult CMPIResult; typedef struct _CMPIObjectPath CMPIObjectPath; typedef struct _CMPIInstance CMPIInstance; typedef struct _CMPIArgs CMPIArgs; typedef struct _CMPIArray CMPIArray; typedef struct _CMPIDateTime CMPIDateTime;
+typedef struct { CMPIrc rc; CMPIString *msg; } CMPIStatus;
+typedef union { unsigned long long uint64; unsigned int uint32; unsigned short uint16; unsigned char uint8; long long sint64; int sint32; short sint16; signed char sint8; float real32; double real64; unsigned char boolean; unsigned short char16; CMPIString *string; char *chars; CMPIDateTime *dateTime; CMPIArray *array; CMPIObjectPath *ref; CMPIInstance *inst; } CMPIValue;
+typedef struct { CMPIType type; CMPIValueState state; CMPIValue value; } CMPIData;
+#define CMPI_boolean 2
+#define CMPI_char16 3
+#define CMPI_real32 4
+#define CMPI_real64 5
+#define CMPI_uint8 8
+#define CMPI_uint16 9
+#define CMPI_uint32 10
+#define CMPI_uint64 11
+#define CMPI_sint8 12
+#define CMPI_sint16 13
+#define CMPI_sint32 14
+#define CMPI_sint64 15
+#define CMPI_ref 16
+#define CMPI_string 17
+#define CMPI_chars 18
+#define CMPI_dateTime 19
+#define CMPI_instance 20
+#define CMPI_ARRAY 0x2000
+#define CMPI_stringA (CMPI_ARRAY|CMPI_string)
+#define CMPI_refA (CMPI_ARRAY|CMPI_ref)
+#define CMPI_nullValue 0x100
+typedef struct _CMPIInstanceMIFT { int miVersion; const char *miName; } CMPIInstanceMIFT;
+typedef struct _CMPIInstanceMI { void *hdl; CMPIInstanceMIFT *ft; } CMPIInstanceMI;
+typedef struct _CMPIMethodMIFT { int miVersion; const char *miName; } CMPIMethodMIFT;
+typedef struct _CMPIMethodMI { void *hdl; CMPIMethodMIFT *ft; } CMPIMethodMI;
+#endif
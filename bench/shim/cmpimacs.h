@@ -0,0 +1,57 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* The CMPI convenience macros the providers use. The accessors that go
+ * through the function tables in the real header are plain functions,
+ * implemented in mock_cmpi.c. */
+#ifndef CMPIMACS_STUB
+#define CMPIMACS_STUB
+#include "cmpidt.h"
+char *CMGetCharPtr(CMPIString*);
+CMPIString *CMGetNameSpace(CMPIObjectPath*, CMPIStatus*);
+CMPIString *CMGetClassName(CMPIObjectPath*, CMPIStatus*);
+CMPIObjectPath *CMNewObjectPath(CMPIBroker*, const char*, const char*, CMPIStatus*);
+CMPIInstance *CMNewInstance(CMPIBroker*, CMPIObjectPath*, CMPIStatus*);
+CMPIArray *CMNewArray(CMPIBroker*, CMPICount, CMPIType, CMPIStatus*);
+CMPIString *CMNewString(CMPIBroker*, const char*, CMPIStatus*);
+CMPIStatus CMSetArrayElementAt(CMPIArray*, CMPICount, void*, CMPIType);
+CMPICount CMGetArrayCount(CMPIArray*, CMPIStatus*);
+CMPIStatus CMAddKey(CMPIObjectPath*, const char*, CMPIValue*, CMPIType);
+CMPIStatus CMSetProperty(CMPIInstance*, const char*, CMPIValue*, CMPIType);
+CMPIData CMGetKey(CMPIObjectPath*, const char*, CMPIStatus*);
+CMPIData CMGetKeyAt(CMPIObjectPath*, unsigned, CMPIString**, CMPIStatus*);
+unsigned CMGetKeyCount(CMPIObjectPath*, CMPIStatus*);
+CMPIData CMGetArg(CMPIArgs*, const char*, CMPIStatus*);
+CMPIStatus CMAddArg(CMPIArgs*, const char*, void*, CMPIType);
+unsigned long long CMGetBinaryFormat(CMPIDateTime*, CMPIStatus*);
+CMPIStatus CMReturnInstance(CMPIResult*, CMPIInstance*);
+CMPIStatus CMReturnObjectPath(CMPIResult*, CMPIObjectPath*);
+CMPIStatus CMReturnData(CMPIResult*, CMPIValue*, CMPIType);
+CMPIStatus CMReturnDone(CMPIResult*);
+#define CMIsNullValue(d) ((d).state & CMPI_nullValue)
+#define CMReturnWithChars(b,rc,chars) do { CMPIStatus stat={(rc),NULL}; (void)(b); return stat; } while(0)
+#define CMReturn(rc) do { CMPIStatus stat={(rc),NULL}; return stat; } while(0)
+#define CMInstanceMIStub(pfx,pn,broker,hook) \
+  static CMPIInstanceMIFT instMIFT__={90,#pn}; \
+  CMPIInstanceMI *pn##_Create_InstanceMI(CMPIBroker *brkr, CMPIContext *ctx) { \
+   static CMPIInstanceMI mi={NULL,&instMIFT__}; \
+   void *f[]={(void*)pfx##Cleanup,(void*)pfx##EnumInstanceNames,(void*)pfx##EnumInstances,(void*)pfx##GetInstance,(void*)pfx##CreateInstance,(void*)pfx##SetInstance,(void*)pfx##DeleteInstance,(void*)pfx##ExecQuery}; (void)f; \
+   broker=brkr; hook; return &mi; }
+#define CMMethodMIStub(pfx,pn,broker,hook) \
+  static CMPIMethodMIFT methMIFT__={90,#pn}; \
+  CMPIMethodMI *pn##_Create_MethodMI(CMPIBroker *brkr, CMPIContext *ctx) { \
+   static CMPIMethodMI mi={NULL,&methMIFT__}; \
+   void *f[]={(void*)pfx##MethodCleanup,(void*)pfx##InvokeMethod}; (void)f; \
+   broker=brkr; hook; return &mi; }
+#define CMNoHook
+#endif
@@ -0,0 +1,32 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* Declarations of the OpenHPI utility functions the providers call. The
+ * benchmarks supply them in mock_hpi.c. */
+#ifndef OH_UTILS_STUB
+#define OH_UTILS_STUB
+#include <SaHpi.h>
+#define OH_MAX_TEXT_BUFFER_LENGTH 2048
+typedef struct { SaHpiUint8T DataType; SaHpiUint8T Language; SaHpiUint16T DataLength; SaHpiUint8T Data[OH_MAX_TEXT_BUFFER_LENGTH]; } oh_big_textbuffer;
+SaErrorT oh_decode_entitypath(const SaHpiEntityPathT*, oh_big_textbuffer*);
+SaErrorT oh_encode_entitypath(const char*, SaHpiEntityPathT*);
+SaErrorT oh_decode_capabilities(SaHpiCapabilitiesT, SaHpiTextBufferT*);
+SaErrorT oh_decode_hscapabilities(SaHpiHsCapabilitiesT, SaHpiTextBufferT*);
+SaErrorT oh_decode_time(SaHpiTimeT, SaHpiTextBufferT*);
+const char *oh_lookup_rdrtype(SaHpiRdrTypeT);
+const char *oh_lookup_severity(SaHpiSeverityT);
+const char *oh_lookup_eventtype(SaHpiEventTypeT);
+const char *oh_lookup_idrfieldtype(SaHpiIdrFieldTypeT);
+const char *oh_lookup_entitytype(SaHpiEntityTypeT);
+SaErrorT oh_encode_severity(SaHpiTextBufferT*, SaHpiSeverityT*);
+#endif
@@ -0,0 +1,47 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _HPI_ARENA_
+#define _HPI_ARENA_
+
+#include <stddef.h>
+
+/* Size of the blocks added once the caller's block is full */
+#define HPI_ARENA_CHUNK         16384
+
+/* Type of a caller's block of 'size' bytes, aligned as the arena aligns
+ * its allocations: hpi_arena_alloc() pads relative to the block start */
+#define HPI_ARENA_BLOCK(size)   union { void *align; char data[size]; }
+
+struct hpi_arena_chunk {
+        struct hpi_arena_chunk *next;
+        size_t                  size;
+        char                    data[];
+};
+
+/* Bump allocator for the scratch data of one request. Allocations are
+ * never freed one by one; hpi_arena_reset() drops them all at once. */
+struct hpi_arena {
+        char                   *block;  /* block being allocated from */
+        size_t                  used;
+        size_t                  size;
+        char                   *first;  /* caller's block, usually on its stack */
+        size_t                  first_size;
+        struct hpi_arena_chunk *chunks; /* blocks added on demand, newest first */
+};
+
+void hpi_arena_init(struct hpi_arena *arena, void *block, size_t size);
+void *hpi_arena_alloc(struct hpi_arena *arena, size_t len);
+char *hpi_arena_strndup(struct hpi_arena *arena, const char *str, size_t len);
+void hpi_arena_reset(struct hpi_arena *arena);
+
+#endif //_HPI_ARENA_
@@ -0,0 +1,87 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _HPI_EVLOG_
+#define _HPI_EVLOG_
+
+#include <pthread.h>
+#include <SaHpi.h>
+
+/* Most recent entries kept per event log */
+#define HPI_EVLOG_MAX_ENTRIES   4096
+
+/* The part of an event log entry served by the event log class */
+struct hpi_evlog_entry {
+        SaHpiEventLogEntryIdT entry_id;
+        SaHpiTimeT            timestamp;        /* when the entry was logged */
+        SaHpiTimeT            event_timestamp;  /* when the event happened */
+        SaHpiResourceIdT      source;
+        SaHpiEventTypeT       event_type;
+        SaHpiSeverityT        severity;
+};
+
+/* Ring of the newest entries of one log. The newest entry is the
+ * high-water mark: reads resume after it while the log's UpdateTimestamp
+ * says there is something new and the entry is still the same. Entries
+ * dropped from the ring are read from HPI again when a filter asks for them. */
+struct hpi_evlog {
+        SaHpiResourceIdT        rid;    /* SAHPI_UNSPECIFIED_RESOURCE_ID for the domain log */
+        int                     synced;
+        SaHpiTimeT              update_timestamp;
+        struct hpi_evlog_entry *ring;
+        unsigned int            head;   /* oldest entry */
+        unsigned int            count;
+        unsigned int            size;
+        SaHpiBoolT              truncated; /* older entries were dropped from the ring */
+};
+
+/* Event logs of the domain, shared by all the providers in the library */
+struct hpi_evlog_cache {
+        pthread_mutex_t   lock;
+        struct hpi_evlog *log;
+        unsigned int      count;
+        unsigned int      size;
+        SaHpiUint64T      generation;   /* inventory generation last swept */
+};
+
+/* Entry filter, checked before an entry is reported. Each range is
+ * inclusive; hpi_evlog_filter_init() sets them to match everything. */
+struct hpi_evlog_filter {
+        int                   one_log;  /* only the log of 'rid' */
+        SaHpiResourceIdT      rid;
+        SaHpiSeverityT        severity_min;
+        SaHpiSeverityT        severity_max;
+        SaHpiTimeT            time_min;
+        SaHpiTimeT            time_max;
+        SaHpiEventLogEntryIdT id_min;
+        SaHpiEventLogEntryIdT id_max;
+};
+
+/* Entry callback, called with the cache locked. Return non-zero to stop. */
+typedef int (*hpi_evlog_cb)(void *data,
+                            SaHpiResourceIdT rid,
+                            const struct hpi_evlog_entry *entry);
+
+struct hpi_inventory;
+
+extern struct hpi_evlog_cache hpi_evlogs;
+
+void hpi_evlog_filter_init(struct hpi_evlog_filter *filter);
+SaErrorT hpi_evlog_foreach(struct hpi_evlog_cache *c,
+                           struct hpi_inventory *inv,
+                           SaHpiSessionIdT sid,
+                           const struct hpi_evlog_filter *filter,
+                           hpi_evlog_cb cb,
+                           void *data);
+void hpi_evlog_entry(struct hpi_evlog_entry *entry, const SaHpiEventLogEntryT *hpi);
+
+#endif //_HPI_EVLOG_
@@ -0,0 +1,84 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _HPI_IDR_
+#define _HPI_IDR_
+
+#include <pthread.h>
+#include <SaHpi.h>
+
+/* Field types CHASSIS_TYPE through ASSET_TAG are cached, one bit each */
+#define HPI_IDR_FIELDS          SAHPI_IDR_FIELDTYPE_CUSTOM
+#define HPI_IDR_FIELD(type)     (1U << (type))
+#define HPI_IDR_ALL_FIELDS      (HPI_IDR_FIELD(HPI_IDR_FIELDS) - 1)
+
+/* Cached contents of one Inventory Data Repository. The fields are fetched
+ * on demand and thrown away when the IDR UpdateCount changes. */
+struct hpi_idr {
+        SaHpiResourceIdT  rid;
+        SaHpiIdrIdT       idrid;
+        SaHpiIdrInfoT     info;
+        int               valid;        /* info is known */
+        int               busy;         /* taken out by a fetch */
+        unsigned int      fetched;      /* field types looked up */
+        unsigned int      present;      /* field types found */
+        SaHpiEntryIdT    *areas;        /* area ids, NULL until walked */
+        unsigned int      nareas;
+        char              field[HPI_IDR_FIELDS][SAHPI_MAX_TEXT_BUFFER_LENGTH + 1];
+};
+
+/* IDR cache shared by all the providers in the library */
+struct hpi_idr_cache {
+        pthread_mutex_t   lock;
+        pthread_cond_t    done;         /* a busy entry was put back */
+        struct hpi_idr   *idr;
+        unsigned int      count;
+        unsigned int      size;
+        unsigned int     *slots;        /* open addressed hash of entry + 1 */
+        unsigned int      slots_size;   /* power of two */
+        SaHpiUint64T      generation;   /* inventory generation last swept */
+
+        /* Background fill after discovery */
+        pthread_t         filler;
+        SaHpiSessionIdT   filler_sid;
+        int               filling;
+        volatile int      stop;
+};
+
+/* Identity of one IDR, as listed from the inventory */
+struct hpi_idr_key {
+        SaHpiResourceIdT  rid;
+        SaHpiIdrIdT       idrid;
+};
+
+/* IDR callback, called on a copy with the cache unlocked. The copy does
+ * not carry the area list. */
+typedef int (*hpi_idr_cb)(void *data, const struct hpi_idr *idr);
+
+struct hpi_inventory;
+
+extern struct hpi_idr_cache hpi_idrs;
+
+int hpi_idr_keys(struct hpi_inventory *inv, struct hpi_idr_key **keys);
+
+SaErrorT hpi_idr_get(struct hpi_idr_cache *c,
+                     struct hpi_inventory *inv,
+                     SaHpiSessionIdT sid,
+                     SaHpiResourceIdT rid,
+                     SaHpiIdrIdT idrid,
+                     unsigned int fields,
+                     hpi_idr_cb cb,
+                     void *data);
+int hpi_idr_fill_start(struct hpi_idr_cache *c, SaHpiSessionIdT sid);
+void hpi_idr_fill_stop(struct hpi_idr_cache *c);
+
+#endif //_HPI_IDR_
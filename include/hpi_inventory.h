@@ -0,0 +1,212 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _HPI_INVENTORY_
+#define _HPI_INVENTORY_
+
+#include <pthread.h>
+#include <SaHpi.h>
+
+/* Kinds of row reported to a hpi_inv_row_cb */
+#define HPI_INV_PRESENT         0
+#define HPI_INV_ADDED           1
+#define HPI_INV_MODIFIED        2
+#define HPI_INV_REMOVED         3
+
+/* One table of instrument columns per RDR type, indexed by SaHpiRdrTypeT */
+#define HPI_INV_RDR_TYPES       (SAHPI_ANNUNCIATOR_RDR + 1)
+
+/* End of a row list; instrument rows are linked as HPI_INV_LINK(type, row) */
+#define HPI_INV_NONE            0xFFFFFFFFU
+#define HPI_INV_LINK(type, row) (((unsigned int)(type) << 28) | (row))
+#define HPI_INV_LINK_TYPE(link) ((link) >> 28)
+#define HPI_INV_LINK_ROW(link)  ((link) & 0x0FFFFFFFU)
+
+/* Health counters are kept per severity: CRITICAL, MAJOR, MINOR,
+ * INFORMATIONAL, OK and anything else */
+#define HPI_INV_SEVERITIES      6
+
+/* Out-of-line storage for resource tags and decoded entity paths */
+struct hpi_inv_pool {
+        char           *data;
+        unsigned int    used;
+        unsigned int    size;
+        unsigned int    waste;          /* bytes no longer referenced */
+};
+
+/* Open addressed hash of row + 1, 0 marks an empty slot */
+struct hpi_inv_index {
+        unsigned int   *slots;
+        unsigned int    size;           /* power of two */
+};
+
+/* Resource columns, one row per resource ever seen */
+struct hpi_inv_resources {
+        unsigned int          count;
+        unsigned int          size;
+        SaHpiResourceIdT     *rid;
+        SaHpiUint32T         *digest;   /* hash of the RPT entry */
+        SaHpiResourceInfoT   *info;
+        SaHpiCapabilitiesT   *capabilities;
+        SaHpiHsCapabilitiesT *hs_capabilities;
+        SaHpiUint8T          *severity;
+        SaHpiUint8T          *failed;
+        SaHpiUint8T          *removed;
+        unsigned int         *tag;      /* string pool offset */
+        unsigned int         *node;     /* entity path trie node */
+        unsigned int         *next_at_node; /* next resource at the same node */
+        unsigned int         *first_rdr; /* instrument rows of this resource */
+        unsigned int         *scan;     /* last scan that saw the resource */
+        struct hpi_inv_index  index;    /* by rid */
+};
+
+/* Instrument columns of one RDR type, one row per RDR ever seen */
+struct hpi_inv_rdrs {
+        unsigned int          count;
+        unsigned int          size;
+        unsigned int         *res;      /* resource row */
+        SaHpiInstrumentIdT   *num;      /* management_instrument_id() of the RDR */
+        SaHpiUint32T         *digest;   /* hash of the RDR */
+        SaHpiUint64T         *created;  /* generation the row (re)appeared in */
+        SaHpiUint64T         *generation; /* generation of the last change */
+        unsigned int         *scan;     /* last scan that saw the RDR */
+        SaHpiUint8T          *removed;  /* tombstone, kept until pruned */
+        unsigned int         *next_rdr; /* next instrument row of the same resource */
+        SaHpiEventStateT     *asserted; /* sensor event states asserted */
+        SaHpiUint8T          *asserted_severity; /* severity of the last assertion */
+        struct hpi_inv_index  index;    /* by resource row and num */
+};
+
+/* Entity path trie, one node per (entity type, location) prefix. Node 0 is
+ * the domain root and each node caches its decoded path. */
+struct hpi_inv_nodes {
+        unsigned int          count;
+        unsigned int          size;
+        SaHpiUint32T         *type;
+        SaHpiEntityLocationT *location;
+        unsigned int         *parent;
+        unsigned int         *child;    /* first child */
+        unsigned int         *sibling;  /* next child of the same parent */
+        unsigned int         *first_res; /* resources whose path ends here */
+        unsigned int         *path;     /* string pool offset */
+        unsigned int         *health;   /* chassis health counters, if any */
+        struct hpi_inv_index  index;    /* by parent, type and location */
+};
+
+/* Health rollup of the domain or of one chassis, kept up to date as
+ * resources and sensor event states change */
+struct hpi_inv_health {
+        unsigned int    node;           /* chassis trie node, 0 for the domain */
+        unsigned int    resources;
+        unsigned int    failed;
+        unsigned int    failed_by_severity[HPI_INV_SEVERITIES];
+        unsigned int    asserted;       /* sensors with event states asserted */
+        unsigned int    asserted_by_severity[HPI_INV_SEVERITIES];
+        /* Domain alarm table counts, only kept for the domain */
+        SaHpiUint32T    active_alarms;
+        SaHpiUint32T    critical_alarms;
+        SaHpiUint32T    major_alarms;
+        SaHpiUint32T    minor_alarms;
+};
+
+/* Generation-tracked, column-oriented copy of the domain inventory */
+struct hpi_inventory {
+        pthread_mutex_t lock;
+        SaHpiDomainIdT  did;
+        SaHpiUint32T    rpt_update_count;
+        int             scanned;        /* a full scan has been done */
+        int             reseed;         /* read every sensor state on the next full scan */
+        unsigned int    scan;           /* scan serial number */
+        SaHpiUint64T    generation;     /* current generation token */
+        SaHpiUint64T    horizon;        /* tokens older than this need a resync */
+        unsigned int    tombstones;
+
+        struct hpi_inv_resources res;
+        struct hpi_inv_rdrs      rdrs[HPI_INV_RDR_TYPES];
+        struct hpi_inv_nodes     nodes;
+        struct hpi_inv_pool      pool;
+
+        struct hpi_inv_health    domain;
+        struct hpi_inv_health   *chassis;
+        unsigned int    nchassis;
+        unsigned int    chassis_size;
+
+        SaHpiResourceIdT *dirty;        /* resources touched by HPI events */
+        unsigned int    ndirty;
+        unsigned int    dirty_size;
+};
+
+/* Read-only view of one instrument row joined with its resource. The
+ * pointers are only valid for the duration of the callback. */
+struct hpi_inv_row {
+        SaHpiDomainIdT             did;
+        SaHpiResourceIdT           rid;
+        SaHpiRdrTypeT              rdr_type;
+        SaHpiInstrumentIdT         num;
+        SaHpiUint64T               generation;
+        const SaHpiResourceInfoT  *info;
+        SaHpiCapabilitiesT         capabilities;
+        SaHpiHsCapabilitiesT       hs_capabilities;
+        SaHpiSeverityT             severity;
+        SaHpiBoolT                 failed;
+        const char                *tag;
+        const char                *entity_path;
+};
+
+/* Row callback, called with the inventory locked. Return non-zero to stop. */
+typedef int (*hpi_inv_row_cb)(void *data, int kind, const struct hpi_inv_row *row);
+
+/* Health callback, called with the inventory locked. 'entity_path' is
+ * NULL for the domain. Return non-zero to stop. */
+typedef int (*hpi_inv_health_cb)(void *data,
+                                 SaHpiDomainIdT did,
+                                 const char *entity_path,
+                                 const struct hpi_inv_health *health);
+
+extern struct hpi_inventory hpi_inv;
+
+SaErrorT hpi_inventory_refresh(struct hpi_inventory *inv, SaHpiSessionIdT sid);
+void hpi_inventory_foreach(struct hpi_inventory *inv,
+                           hpi_inv_row_cb cb,
+                           void *data);
+void hpi_inventory_foreach_type(struct hpi_inventory *inv,
+                                SaHpiRdrTypeT type,
+                                hpi_inv_row_cb cb,
+                                void *data);
+int hpi_inventory_present(struct hpi_inventory *inv,
+                          SaHpiResourceIdT rid,
+                          SaHpiRdrTypeT type,
+                          SaHpiInstrumentIdT num);
+SaHpiDomainIdT hpi_inventory_domain(struct hpi_inventory *inv);
+SaHpiUint64T hpi_inventory_generation(struct hpi_inventory *inv);
+int hpi_inventory_capable(struct hpi_inventory *inv,
+                          SaHpiCapabilitiesT capabilities,
+                          SaHpiResourceIdT **rids);
+int hpi_inventory_subtree(struct hpi_inventory *inv,
+                          const SaHpiEntityPathT *ep,
+                          int descend,
+                          hpi_inv_row_cb cb,
+                          void *data);
+void hpi_inventory_health(struct hpi_inventory *inv,
+                          hpi_inv_health_cb cb,
+                          void *data);
+int hpi_inventory_health_get(struct hpi_inventory *inv,
+                             const SaHpiEntityPathT *chassis,
+                             hpi_inv_health_cb cb,
+                             void *data);
+int hpi_inventory_changes(struct hpi_inventory *inv,
+                          SaHpiUint64T since,
+                          SaHpiUint64T *generation,
+                          hpi_inv_row_cb cb,
+                          void *data);
+
+#endif //_HPI_INVENTORY_
@@ -0,0 +1,45 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+#ifndef _HPI_QUERY_
+#define _HPI_QUERY_
+
+#define HPI_QUERY_MAX_CONDS     8
+
+/* Comparison operators */
+#define HPI_QUERY_EQ            1
+#define HPI_QUERY_NE            2
+#define HPI_QUERY_LT            3
+#define HPI_QUERY_LE            4
+#define HPI_QUERY_GT            5
+#define HPI_QUERY_GE            6
+#define HPI_QUERY_LIKE          7
+
+/* One "Property op literal" term of a WHERE clause */
+struct hpi_query_cond {
+        char property[64];
+        int  op;
+        int  is_string;                 /* literal was quoted */
+        char value[1024];
+};
+
+/* "SELECT * FROM Class [WHERE cond [AND cond]...]" */
+struct hpi_query {
+        char classname[256];
+        int  ncond;
+        struct hpi_query_cond cond[HPI_QUERY_MAX_CONDS];
+};
+
+int hpi_query_parse(const char *language, const char *query, struct hpi_query *q);
+struct hpi_query_cond *hpi_query_find(struct hpi_query *q, const char *property);
+
+#endif //_HPI_QUERY_
@@ -16,8 +16,23 @@
 #ifndef _HPI_UTILS_
 #define _HPI_UTILS_
 
+#include <stddef.h>
 #include <SaHpi.h>
 
+/* HPI session shared by all the providers in the library */
+struct hpi_handle {
+        SaHpiSessionIdT sid;
+        SaHpiDomainInfoT domain_info;
+};
+
+extern struct hpi_handle hpi_hnd;
+
+SaErrorT hpi_session_open(void);
 int management_instrument_id(SaHpiRdrT  *rdr);
+int hpi_device_id(char *buf, size_t len,
+                  SaHpiDomainIdT did,
+                  SaHpiResourceIdT rid,
+                  SaHpiRdrTypeT type,
+                  SaHpiInstrumentIdT num);
 
 #endif //_HPI_UTILS_
@@ -0,0 +1,551 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* Name of this provider */
+static char _CLASSNAME[] = "HPI_EventLogEntry";
+
+#define CMPI_VERSION 90
+
+/* Include the required C library headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <limits.h>
+#include <errno.h>
+
+/* Include the required CMPI macros, data types, and API function headers */
+#include "cmpidt.h"
+#include "cmpift.h"
+#include "cmpimacs.h"
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include <hpi_utils.h>
+#include <hpi_inventory.h>
+#include <hpi_evlog.h>
+#include <hpi_query.h>
+
+/* Simple logging facility, in case the standard SBLIM _OSBASE_TRACE() isn't available */
+#ifndef _OSBASE_TRACE
+#include <stdarg.h>
+#define _OSBASE_TRACE(x,y) _logstderr y
+static void _logstderr(char *fmt,...)
+{
+   va_list ap;
+   va_start(ap,fmt);
+   vfprintf(stderr,fmt,ap);
+   va_end(ap);
+   fprintf(stderr,"\n");
+}
+#endif
+
+
+/* Handle to the CIM broker. This is initialized by the CIMOM when the provider is loaded */
+static CMPIBroker * _BROKER;
+
+
+/* Build the Name key of one entry */
+static void entry_name(char * buf, size_t len, SaHpiDomainIdT did,
+                       SaHpiResourceIdT rid, SaHpiEventLogEntryIdT entry_id)
+{
+        snprintf(buf, len, "{Domain ID=%d}{Resource ID=%u}{Entry ID=%u}", did, rid, entry_id);
+}
+
+
+/* Per-request state handed to the entry callbacks below */
+struct evlog_request {
+        CMPIResult * results;
+        char * namespace;
+        char * classname;
+        SaHpiDomainIdT did;
+        CMPIStatus status;
+};
+
+
+/* Entry callback that returns the object path of one entry */
+static int return_object_path(void * data, SaHpiResourceIdT rid,
+                              const struct hpi_evlog_entry * entry)
+{
+        struct evlog_request * req = data;
+        CMPIObjectPath * objectpath;
+        char buf[256];
+
+        objectpath = CMNewObjectPath(_BROKER, req->namespace, req->classname, &req->status);
+        if (req->status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to create new object path - %s",
+                                 _CLASSNAME, CMGetCharPtr(req->status.msg)));
+                return 1;
+        }
+
+        entry_name(buf, sizeof(buf), req->did, rid, entry->entry_id);
+        CMAddKey(objectpath, "Name", (CMPIValue *)buf, CMPI_chars);
+
+        CMReturnObjectPath(req->results, objectpath);
+        return 0;
+}
+
+
+/* Entry callback that returns the full instance data of one entry */
+static int return_instance(void * data, SaHpiResourceIdT rid,
+                           const struct hpi_evlog_entry * entry)
+{
+        struct evlog_request * req = data;
+        CMPIInstance * instance;
+        SaHpiUint32T severity;
+        char buf[256];
+
+        instance = CMNewInstance(_BROKER, CMNewObjectPath(_BROKER, req->namespace, req->classname, &req->status), &req->status);
+        if (req->status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to create new instance - %s",
+                                 _CLASSNAME, CMGetCharPtr(req->status.msg)));
+                return 1;
+        }
+
+        entry_name(buf, sizeof(buf), req->did, rid, entry->entry_id);
+        CMSetProperty(instance, "Name", (CMPIValue *)buf, CMPI_chars);
+        CMSetProperty(instance, "DID", (CMPIValue *)&req->did, CMPI_uint32);
+        CMSetProperty(instance, "LogRID", (CMPIValue *)&rid, CMPI_uint32);
+        CMSetProperty(instance, "LogScope",
+                      (CMPIValue *)((rid == SAHPI_UNSPECIFIED_RESOURCE_ID) ? "Domain" : "Resource"), CMPI_chars);
+        CMSetProperty(instance, "EntryId", (CMPIValue *)&entry->entry_id, CMPI_uint32);
+        CMSetProperty(instance, "Timestamp", (CMPIValue *)&entry->timestamp, CMPI_sint64);
+
+        /* Event */
+        CMSetProperty(instance, "EventTimestamp", (CMPIValue *)&entry->event_timestamp, CMPI_sint64);
+        CMSetProperty(instance, "Source", (CMPIValue *)&entry->source, CMPI_uint32);
+        CMSetProperty(instance, "EventType",
+                      (CMPIValue *)oh_lookup_eventtype(entry->event_type), CMPI_chars);
+        severity = entry->severity;
+        CMSetProperty(instance, "Severity", (CMPIValue *)&severity, CMPI_uint32);
+
+        CMReturnInstance(req->results, instance);
+        return 0;
+}
+
+
+/* Narrow the inclusive range [*min, *max] by one comparison. Returns 0 on
+ * success, 1 if the range is now empty, -1 if 'op' is not a comparison. */
+static int narrow(int op, long long value, long long * min, long long * max)
+{
+        switch (op) {
+                case HPI_QUERY_EQ:
+                        if (value > *min) *min = value;
+                        if (value < *max) *max = value;
+                        break;
+                case HPI_QUERY_LT:
+                        if (value == LLONG_MIN)
+                                return 1;
+                        value--;
+                        /* fall through */
+                case HPI_QUERY_LE:
+                        if (value < *max) *max = value;
+                        break;
+                case HPI_QUERY_GT:
+                        if (value == LLONG_MAX)
+                                return 1;
+                        value++;
+                        /* fall through */
+                case HPI_QUERY_GE:
+                        if (value > *min) *min = value;
+                        break;
+                default:
+                        return -1;
+        }
+        return (*min > *max) ? 1 : 0;
+}
+
+
+/* Turn the WHERE clause into an entry filter. Each range starts as the
+ * whole range of its property, so a bound outside it empties the range
+ * instead of being clamped. Returns 0 on success, 1 if no entry can match,
+ * -1 if the query uses something the filter cannot express. */
+static int query_filter(struct hpi_query * q, struct hpi_evlog_filter * filter)
+{
+        struct hpi_query_cond * cond;
+        long long value, min, max;
+        char * end;
+        int i, empty = 0;
+
+        hpi_evlog_filter_init(filter);
+
+        for (i = 0; i < q->ncond; i++) {
+                cond = &q->cond[i];
+                if (cond->is_string)
+                        return -1;
+                errno = 0;
+                value = strtoll(cond->value, &end, 0);
+                if (*end != '\0' || end == cond->value || errno == ERANGE)
+                        return -1;
+
+                if (strcasecmp(cond->property, "Severity") == 0) {
+                        min = filter->severity_min;
+                        max = filter->severity_max;
+                        switch (narrow(cond->op, value, &min, &max)) {
+                                case -1: return -1;
+                                case 1:  empty = 1; break;
+                                default:
+                                        filter->severity_min = min;
+                                        filter->severity_max = max;
+                        }
+                } else if (strcasecmp(cond->property, "Timestamp") == 0) {
+                        min = filter->time_min;
+                        max = filter->time_max;
+                        switch (narrow(cond->op, value, &min, &max)) {
+                                case -1: return -1;
+                                case 1:  empty = 1; break;
+                                default:
+                                        filter->time_min = min;
+                                        filter->time_max = max;
+                        }
+                } else if (strcasecmp(cond->property, "EntryId") == 0) {
+                        min = filter->id_min;
+                        max = filter->id_max;
+                        switch (narrow(cond->op, value, &min, &max)) {
+                                case -1: return -1;
+                                case 1:  empty = 1; break;
+                                default:
+                                        filter->id_min = min;
+                                        filter->id_max = max;
+                        }
+                } else if (strcasecmp(cond->property, "LogRID") == 0 &&
+                           cond->op == HPI_QUERY_EQ) {
+                        if (value < 0 || value > UINT32_MAX ||
+                            (filter->one_log && filter->rid != value))
+                                empty = 1;
+                        filter->one_log = 1;
+                        filter->rid = value;
+                } else {
+                        return -1;
+                }
+        }
+        return empty;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * CMPI INSTANCE PROVIDER FUNCTIONS
+ * --------------------------------------------------------------------------- */
+
+/* EnumInstanceNames() - return a list of all the instances names (i.e. return their object paths only) */
+static CMPIStatus EnumInstanceNames(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference)	/* [in] Contains the CIM namespace and classname */
+{
+        SaErrorT error;
+        struct hpi_evlog_filter filter;
+        struct evlog_request req = { results, NULL, NULL, 0, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:EnumInstanceNames() called", _CLASSNAME));
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error == SA_OK) {
+                req.did = hpi_inventory_domain(&hpi_inv);
+                hpi_evlog_filter_init(&filter);
+                error = hpi_evlog_foreach(&hpi_evlogs, &hpi_inv, hpi_hnd.sid, &filter,
+                                          return_object_path, &req);
+        }
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new object path");
+        }
+
+        /* Finished EnumInstanceNames */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:EnumInstanceNames() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* EnumInstances() - return a list of all the instances (i.e. return all their instance data) */
+static CMPIStatus EnumInstances(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace and classname */
+		char ** properties)		/* [in] List of desired properties (NULL=all) */
+{
+        SaErrorT error;
+        struct hpi_evlog_filter filter;
+        struct evlog_request req = { results, NULL, NULL, 0, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:EnumInstances() called", _CLASSNAME));
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error == SA_OK) {
+                req.did = hpi_inventory_domain(&hpi_inv);
+                hpi_evlog_filter_init(&filter);
+                error = hpi_evlog_foreach(&hpi_evlogs, &hpi_inv, hpi_hnd.sid, &filter,
+                                          return_instance, &req);
+        }
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
+
+        /* Finished EnumInstances */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:EnumInstances() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* GetInstance() -  return the instance data for the specified instance only */
+/* A single entry is read straight from HPI, so entries older than the kept ones can be read too */
+static CMPIStatus GetInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		char ** properties)		/* [in] List of desired properties (NULL=all) */
+{
+        SaErrorT error;
+        CMPIData nameData;
+        SaHpiDomainIdT did;
+        SaHpiResourceIdT rid;
+        SaHpiEventLogEntryIdT entry_id, prev, next;
+        SaHpiEventLogEntryT hpi;
+        struct hpi_evlog_entry entry;
+        struct evlog_request req = { results, NULL, NULL, 0, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:GetInstance() called", _CLASSNAME));
+
+        nameData = CMGetKey(reference, "Name", &req.status);
+        if (req.status.rc != CMPI_RC_OK || CMIsNullValue(nameData)) {
+                _OSBASE_TRACE(1,("%s:GetInstance() : Cannot determine desired entry", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Cannot determine desired entry");
+        }
+
+        if (sscanf(CMGetCharPtr(nameData.value.string),
+                   "{Domain ID=%u}{Resource ID=%u}{Entry ID=%u}", &did, &rid, &entry_id) != 3) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "Invalid entry name");
+        }
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:GetInstance() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+        if (did != hpi_inventory_domain(&hpi_inv)) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "No such domain");
+        }
+        req.did = did;
+
+        error = saHpiEventLogEntryGet(hpi_hnd.sid, rid, entry_id, &prev, &next, &hpi, NULL, NULL);
+        if (error == SA_ERR_HPI_NOT_PRESENT || error == SA_ERR_HPI_INVALID_RESOURCE ||
+            error == SA_ERR_HPI_CAPABILITY) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "No such entry");
+        }
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:GetInstance() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+
+        hpi_evlog_entry(&entry, &hpi);
+        return_instance(&req, rid, &entry);
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
+
+        /* Finished */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:GetInstance() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* SetInstance() - save modified instance data for the specified instance */
+static CMPIStatus SetInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		CMPIInstance * newinstance)	/* [in] Contains all the new instance data */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:SetInstance() called", self->ft->miName));
+
+        /* Modifying existing instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:SetInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* CreateInstance() - create a new instance from the specified instance data */
+static CMPIStatus CreateInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		CMPIInstance * newinstance)	/* [in] Contains all the new instance data */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:CreateInstance() called", self->ft->miName));
+
+        /* Creating new instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:CreateInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* DeleteInstance() - delete/remove the specified instance */
+static CMPIStatus DeleteInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference)	/* [in] Contains the CIM namespace, classname and desired object path */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:DeleteInstance() called", self->ft->miName));
+
+        /* Deleting instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:DeleteInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* ExecQuery() - return a list of all the instances that 'satisfy' the desired query filter */
+/* Conditions on Severity, Timestamp, EntryId and LogRID are applied before instances are built */
+static CMPIStatus ExecQuery(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace and classname */
+		char * language,		/* [in] Name of the query language (e.g. "WQL") */
+		char * query)			/* [in] Text of the query, written in the query language */
+{
+        SaErrorT error;
+        struct hpi_query q;
+        struct hpi_evlog_filter filter;
+        int empty;
+        struct evlog_request req = { results, NULL, NULL, 0, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:ExecQuery() called", _CLASSNAME));
+
+        if (hpi_query_parse(language, query, &q) != 0 ||
+            strcasecmp(q.classname, req.classname) != 0) {
+                _OSBASE_TRACE(1,("%s:ExecQuery() : Unsupported query %s", _CLASSNAME, query));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_INVALID_QUERY, "Unsupported query");
+        }
+        empty = query_filter(&q, &filter);
+        if (empty < 0) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_SUPPORTED,
+                                  "Only numeric comparisons on Severity, Timestamp and EntryId, "
+                                  "and LogRID = n are supported");
+        }
+        if (empty) {
+                /* The conditions cannot all hold, so there is nothing to read */
+                CMReturnDone(results);
+                _OSBASE_TRACE(1,("%s:ExecQuery() succeeded", _CLASSNAME));
+                CMReturn(CMPI_RC_OK);
+        }
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error == SA_OK) {
+                req.did = hpi_inventory_domain(&hpi_inv);
+                error = hpi_evlog_foreach(&hpi_evlogs, &hpi_inv, hpi_hnd.sid, &filter,
+                                          return_instance, &req);
+        }
+        if (error == SA_ERR_HPI_NOT_PRESENT) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "No such event log");
+        }
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:ExecQuery() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
+
+        /* Finished */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:ExecQuery() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* Cleanup() - perform any necessary cleanup immediately before this provider is unloaded */
+static CMPIStatus Cleanup(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context)		/* [in] Additional context info, if any */
+{
+        CMPIStatus status = {CMPI_RC_OK, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:Cleanup() called", self->ft->miName));
+
+        /* Nothing needs to be done for cleanup */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:Cleanup() %s", self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* OPTIONAL: Initialize() is *NOT* a predefined CMPI method. See CMInstanceMIStub() below */
+static void Initialize(
+		CMPIBroker *broker)		/* [in] Handle to the CIMOM */
+{
+        SaErrorT error = SA_OK;
+
+        _OSBASE_TRACE(1,("%s:Initialize() called", _CLASSNAME));
+
+        /* All the providers in this library share one session and one inventory */
+        error = hpi_session_open();
+        if (error) {
+                _OSBASE_TRACE(1,("%s:hpi_session_open() failed", _CLASSNAME));
+                return;
+        }
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error) {
+                _OSBASE_TRACE(1,("%s:hpi_inventory_refresh() failed", _CLASSNAME));
+        }
+
+        _OSBASE_TRACE(1,("%s:Initialize() succeeded", _CLASSNAME));
+}
+
+
+/* ---------------------------------------------------------------------------
+ * CMPI PROVIDER SETUP
+ * --------------------------------------------------------------------------- */
+
+/* See Hpi.c for a description of the factory parameters */
+CMInstanceMIStub( , HPI_EventLogEntryProvider, _BROKER, Initialize(_BROKER));
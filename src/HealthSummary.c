@@ -0,0 +1,426 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* Name of this provider */
+static char _CLASSNAME[] = "HPI_HealthSummary";
+
+#define CMPI_VERSION 90
+
+/* Include the required C library headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Include the required CMPI macros, data types, and API function headers */
+#include "cmpidt.h"
+#include "cmpift.h"
+#include "cmpimacs.h"
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include <hpi_utils.h>
+#include <hpi_inventory.h>
+
+/* Per-severity counters, in the inventory's HPI_INV_SEVERITIES order */
+static char * _FAILEDNAMES[] = {"FailedCritical", "FailedMajor", "FailedMinor",
+                                "FailedInformational", "FailedOk", "FailedOther", NULL};
+static char * _ASSERTEDNAMES[] = {"AssertedCritical", "AssertedMajor", "AssertedMinor",
+                                  "AssertedInformational", "AssertedOk", "AssertedOther", NULL};
+
+/* Simple logging facility, in case the standard SBLIM _OSBASE_TRACE() isn't available */
+#ifndef _OSBASE_TRACE
+#include <stdarg.h>
+#define _OSBASE_TRACE(x,y) _logstderr y
+static void _logstderr(char *fmt,...)
+{
+   va_list ap;
+   va_start(ap,fmt);
+   vfprintf(stderr,fmt,ap);
+   va_end(ap);
+   fprintf(stderr,"\n");
+}
+#endif
+
+
+/* Handle to the CIM broker. This is initialized by the CIMOM when the provider is loaded */
+static CMPIBroker * _BROKER;
+
+
+/* Build the Name key: "{Domain ID=n}" for the domain, "{Domain ID=n}{Chassis=path}" per chassis */
+static void health_name(char * buf, size_t len, SaHpiDomainIdT did, const char * entity_path)
+{
+        if (entity_path == NULL)
+                snprintf(buf, len, "{Domain ID=%d}", did);
+        else
+                snprintf(buf, len, "{Domain ID=%d}{Chassis=%s}", did, entity_path);
+}
+
+
+/* Per-request state handed to the health callbacks below */
+struct health_request {
+        CMPIResult * results;
+        char * namespace;
+        char * classname;
+        CMPIStatus status;
+};
+
+
+/* Health callback that returns the object path of one instance */
+static int return_object_path(void * data, SaHpiDomainIdT did,
+                              const char * entity_path,
+                              const struct hpi_inv_health * health)
+{
+        struct health_request * req = data;
+        CMPIObjectPath * objectpath;
+        char buf[1024];
+
+        objectpath = CMNewObjectPath(_BROKER, req->namespace, req->classname, &req->status);
+        if (req->status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to create new object path - %s",
+                                 _CLASSNAME, CMGetCharPtr(req->status.msg)));
+                return 1;
+        }
+
+        health_name(buf, sizeof(buf), did, entity_path);
+        CMAddKey(objectpath, "Name", (CMPIValue *)buf, CMPI_chars);
+
+        CMReturnObjectPath(req->results, objectpath);
+        return 0;
+}
+
+
+/* Health callback that returns the full instance data of one instance */
+static int return_instance(void * data, SaHpiDomainIdT did,
+                           const char * entity_path,
+                           const struct hpi_inv_health * health)
+{
+        struct health_request * req = data;
+        CMPIInstance * instance;
+        char buf[1024];
+        int i;
+
+        instance = CMNewInstance(_BROKER, CMNewObjectPath(_BROKER, req->namespace, req->classname, &req->status), &req->status);
+        if (req->status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to create new instance - %s",
+                                 _CLASSNAME, CMGetCharPtr(req->status.msg)));
+                return 1;
+        }
+
+        health_name(buf, sizeof(buf), did, entity_path);
+        CMSetProperty(instance, "Name", (CMPIValue *)buf, CMPI_chars);
+        CMSetProperty(instance, "ElementName", (CMPIValue *)buf, CMPI_chars);
+        CMSetProperty(instance, "Scope",
+                      (CMPIValue *)((entity_path == NULL) ? "Domain" : "Chassis"), CMPI_chars);
+        CMSetProperty(instance, "DID", (CMPIValue *)&did, CMPI_uint32);
+        if (entity_path != NULL)
+                CMSetProperty(instance, "EntityPath", (CMPIValue *)entity_path, CMPI_chars);
+
+        /* Resources */
+        CMSetProperty(instance, "Resources", (CMPIValue *)&health->resources, CMPI_uint32);
+        CMSetProperty(instance, "FailedResources", (CMPIValue *)&health->failed, CMPI_uint32);
+        for (i = 0; _FAILEDNAMES[i] != NULL; i++)
+                CMSetProperty(instance, _FAILEDNAMES[i],
+                              (CMPIValue *)&health->failed_by_severity[i], CMPI_uint32);
+
+        /* Sensor event states */
+        CMSetProperty(instance, "AssertedSensors", (CMPIValue *)&health->asserted, CMPI_uint32);
+        for (i = 0; _ASSERTEDNAMES[i] != NULL; i++)
+                CMSetProperty(instance, _ASSERTEDNAMES[i],
+                              (CMPIValue *)&health->asserted_by_severity[i], CMPI_uint32);
+
+        /* Domain alarm table */
+        if (entity_path == NULL) {
+                CMSetProperty(instance, "ActiveAlarms", (CMPIValue *)&health->active_alarms, CMPI_uint32);
+                CMSetProperty(instance, "CriticalAlarms", (CMPIValue *)&health->critical_alarms, CMPI_uint32);
+                CMSetProperty(instance, "MajorAlarms", (CMPIValue *)&health->major_alarms, CMPI_uint32);
+                CMSetProperty(instance, "MinorAlarms", (CMPIValue *)&health->minor_alarms, CMPI_uint32);
+        }
+
+        CMReturnInstance(req->results, instance);
+        return 0;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * CMPI INSTANCE PROVIDER FUNCTIONS
+ * --------------------------------------------------------------------------- */
+
+/* EnumInstanceNames() - return a list of all the instances names (i.e. return their object paths only) */
+static CMPIStatus EnumInstanceNames(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference)	/* [in] Contains the CIM namespace and classname */
+{
+        SaErrorT error;
+        struct health_request req = { results, NULL, NULL, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:EnumInstanceNames() called", _CLASSNAME));
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+
+        hpi_inventory_health(&hpi_inv, return_object_path, &req);
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new object path");
+        }
+
+        /* Finished EnumInstanceNames */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:EnumInstanceNames() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* EnumInstances() - return a list of all the instances (i.e. return all their instance data) */
+static CMPIStatus EnumInstances(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace and classname */
+		char ** properties)		/* [in] List of desired properties (NULL=all) */
+{
+        SaErrorT error;
+        struct health_request req = { results, NULL, NULL, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:EnumInstances() called", _CLASSNAME));
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+
+        hpi_inventory_health(&hpi_inv, return_instance, &req);
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
+
+        /* Finished EnumInstances */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:EnumInstances() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* GetInstance() -  return the instance data for the specified instance only */
+/* The counters are maintained as the inventory changes, so this is a lookup and not a walk */
+static CMPIStatus GetInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		char ** properties)		/* [in] List of desired properties (NULL=all) */
+{
+        SaErrorT error;
+        SaHpiEntityPathT ep;
+        SaHpiDomainIdT did;
+        CMPIData nameData;
+        char * name, * chassis = NULL, * end;
+        int found, offset = 0;
+        struct health_request req = { results, NULL, NULL, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:GetInstance() called", _CLASSNAME));
+
+        nameData = CMGetKey(reference, "Name", &req.status);
+        if (req.status.rc != CMPI_RC_OK || CMIsNullValue(nameData)) {
+                _OSBASE_TRACE(1,("%s:GetInstance() : Cannot determine desired health summary", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Cannot determine desired health summary");
+        }
+        name = CMGetCharPtr(nameData.value.string);
+
+        if (sscanf(name, "{Domain ID=%u}%n", &did, &offset) != 1 || offset == 0) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "Invalid health summary name");
+        }
+        if (name[offset] != '\0') {
+                if (strncmp(name + offset, "{Chassis=", 9) != 0 ||
+                    (end = strrchr(name + offset, '}')) == NULL || end[1] != '\0') {
+                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "Invalid health summary name");
+                }
+                chassis = strdup(name + offset + 9);
+                if (chassis == NULL) {
+                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Out of memory");
+                }
+                chassis[end - (name + offset + 9)] = '\0';
+
+                memset(&ep, 0, sizeof(ep));
+                error = oh_encode_entitypath(chassis, &ep);
+                free(chassis);
+                if (error != SA_OK) {
+                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "Invalid health summary name");
+                }
+        }
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:GetInstance() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+        if (did != hpi_inventory_domain(&hpi_inv)) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "No such domain");
+        }
+
+        found = hpi_inventory_health_get(&hpi_inv, chassis ? &ep : NULL, return_instance, &req);
+        if (found != 0) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "No such chassis");
+        }
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
+
+        /* Finished */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:GetInstance() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* SetInstance() - save modified instance data for the specified instance */
+static CMPIStatus SetInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		CMPIInstance * newinstance)	/* [in] Contains all the new instance data */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:SetInstance() called", self->ft->miName));
+
+        /* Modifying existing instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:SetInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* CreateInstance() - create a new instance from the specified instance data */
+static CMPIStatus CreateInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		CMPIInstance * newinstance)	/* [in] Contains all the new instance data */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:CreateInstance() called", self->ft->miName));
+
+        /* Creating new instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:CreateInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* DeleteInstance() - delete/remove the specified instance */
+static CMPIStatus DeleteInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference)	/* [in] Contains the CIM namespace, classname and desired object path */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:DeleteInstance() called", self->ft->miName));
+
+        /* Deleting instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:DeleteInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* ExecQuery() - return a list of all the instances that 'satisfy' the desired query filter */
+static CMPIStatus ExecQuery(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace and classname */
+		char * language,		/* [in] Name of the query language (e.g. "WQL") */
+		char * query)			/* [in] Text of the query, written in the query language */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:ExecQuery() called", self->ft->miName));
+
+        /* Query filtering is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:ExecQuery() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* Cleanup() - perform any necessary cleanup immediately before this provider is unloaded */
+static CMPIStatus Cleanup(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context)		/* [in] Additional context info, if any */
+{
+        CMPIStatus status = {CMPI_RC_OK, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:Cleanup() called", self->ft->miName));
+
+        /* Nothing needs to be done for cleanup */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:Cleanup() %s", self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* OPTIONAL: Initialize() is *NOT* a predefined CMPI method. See CMInstanceMIStub() below */
+static void Initialize(
+		CMPIBroker *broker)		/* [in] Handle to the CIMOM */
+{
+        SaErrorT error = SA_OK;
+
+        _OSBASE_TRACE(1,("%s:Initialize() called", _CLASSNAME));
+
+        /* All the providers in this library share one session and one inventory */
+        error = hpi_session_open();
+        if (error) {
+                _OSBASE_TRACE(1,("%s:hpi_session_open() failed", _CLASSNAME));
+                return;
+        }
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error) {
+                _OSBASE_TRACE(1,("%s:hpi_inventory_refresh() failed", _CLASSNAME));
+        }
+
+        _OSBASE_TRACE(1,("%s:Initialize() succeeded", _CLASSNAME));
+}
+
+
+/* ---------------------------------------------------------------------------
+ * CMPI PROVIDER SETUP
+ * --------------------------------------------------------------------------- */
+
+/* See Hpi.c for a description of the factory parameters */
+CMInstanceMIStub( , HPI_HealthSummaryProvider, _BROKER, Initialize(_BROKER));
@@ -21,6 +21,11 @@ static char _CLASSNAME[] = "HPI_LogicalDevice";
 
 #define CMPI_VERSION 90
  
+/* Include the required C library headers */
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
 /* Include the required CMPI macros, data types, and API function headers */
 #include "cmpidt.h"
 #include "cmpift.h"
@@ -28,10 +33,22 @@ static char _CLASSNAME[] = "HPI_LogicalDevice";
 #include <SaHpi.h>
 #include <oh_utils.h>
 #include <hpi_utils.h>
+#include <hpi_inventory.h>
+#include <hpi_query.h>
+#include <hpi_arena.h>
 
 /* NULL terminated list of key property names for this class */
 static char * _KEYNAMES[] = {"RID", NULL};
 
+/* GetChanges() keeps its DeviceIDs in an arena. A DeviceID is 82 bytes of
+ * text plus the ids and the RDR type name, under 128 bytes while the ids
+ * stay below a million. A poll usually finds a few changes, so the stack
+ * block holds 32; a resync takes the rest from the heap. */
+#define CHANGES_SCRATCH (32 * 128)
+
+/* Output arguments of GetChanges(), in HPI_INV_ADDED/MODIFIED/REMOVED order */
+static char * _CHANGENAMES[] = {"Added", "Modified", "Removed", NULL};
+
 /* Simple logging facility, in case the standard SBLIM _OSBASE_TRACE() isn't available */
 #ifndef _OSBASE_TRACE
 #include <stdarg.h>
@@ -46,11 +63,6 @@ void _logstderr(char *fmt,...)
 }
 #endif
 
-static struct hpi_handle {
-        SaHpiSessionIdT sid;
-        SaHpiDomainInfoT domain_info;
-} hpi_hnd;
-
 
 /* Handle to the CIM broker. This is initialized by the CIMOM when the provider is loaded */
 static CMPIBroker * _BROKER;
@@ -60,100 +72,242 @@ static CMPIBroker * _BROKER;
  * CMPI INSTANCE PROVIDER FUNCTIONS
  * --------------------------------------------------------------------------- */
 
-/* EnumInstanceNames() - return a list of all the instances names (i.e. return their object paths only) */
-static CMPIStatus EnumInstanceNames(
-		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
-		CMPIContext * context,		/* [in] Additional context info, if any */
-		CMPIResult * results,		/* [out] Results of this operation */
-		CMPIObjectPath * reference)	/* [in] Contains the CIM namespace and classname */
+/* Capability masks decoded during one request. A domain uses only a few
+ * distinct masks, so each is decoded once and its text kept in the arena. */
+#define DECODED_MAX 8
+
+/* Arena block of an enumeration: room for both tables full of the longest
+ * texts, each rounded up to the arena's alignment, so it never needs more */
+#define DECODED_SCRATCH (2 * DECODED_MAX * (SAHPI_MAX_TEXT_BUFFER_LENGTH + sizeof(void *)))
+
+struct decoded {
+        unsigned int count;
+        SaHpiUint32T mask[DECODED_MAX];
+        const char * text[DECODED_MAX];
+        char spill[SAHPI_MAX_TEXT_BUFFER_LENGTH + 1]; /* reused once the table is full */
+};
+
+/* Per-request state handed to the inventory row callbacks below */
+struct enum_request {
+        CMPIResult * results;
+        char * namespace;
+        char * classname;
+        CMPIStatus status;
+        struct hpi_arena * arena;       /* decoded text, dropped at the end of the request */
+        struct decoded capabilities;
+        struct decoded hs_capabilities;
+};
+
+
+static const char * decoded_find(struct decoded * d, SaHpiUint32T mask)
 {
-        /* HPI vars */
-        SaErrorT error;
-        SaHpiRptEntryT entry;
-        SaHpiEntryIdT entry_id = SAHPI_FIRST_ENTRY;
+        unsigned int i;
 
-        SaHpiEntryIdT rdr_id;
-        SaHpiRdrT     rdr;
-        int rval;
+        for (i = 0; i < d->count; i++)
+                if (d->mask[i] == mask)
+                        return d->text[i];
+        return NULL;
+}
 
-        char buf[1024];
+/* Keep the text of a newly decoded mask. Once the table is full (or the
+ * arena is) the text goes to the spill buffer, so arena use stays bounded. */
+static const char * decoded_add(struct decoded * d, struct hpi_arena * arena,
+                                SaHpiUint32T mask, const SaHpiTextBufferT * buffer)
+{
+        const char * text = NULL;
+
+        if (d->count < DECODED_MAX)
+                text = hpi_arena_strndup(arena, (char *)buffer->Data, buffer->DataLength);
+        if (text == NULL) {
+                memcpy(d->spill, buffer->Data, buffer->DataLength);
+                d->spill[buffer->DataLength] = '\0';
+                return d->spill;
+        }
+        d->mask[d->count] = mask;
+        d->text[d->count++] = text;
+        return text;
+}
 
-        /* Commonly needed vars */
-        CMPIStatus status = {CMPI_RC_OK, NULL};	/* Return status of CIM operations */
-        CMPIObjectPath * objectpath; /* CIM object path of each new instance of this class */
-        char * namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
-        char * classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+static const char * decode_capabilities(struct enum_request * req, SaHpiCapabilitiesT capabilities)
+{
+        SaHpiTextBufferT buffer;
+        const char * text;
+
+        text = decoded_find(&req->capabilities, capabilities);
+        if (text == NULL) {
+                if (oh_decode_capabilities(capabilities, &buffer) != SA_OK)
+                        return "";
+                text = decoded_add(&req->capabilities, req->arena, capabilities, &buffer);
+        }
+        return text;
+}
 
-        _OSBASE_TRACE(1,("%s:EnumInstanceNames() called", _CLASSNAME));
+static const char * decode_hscapabilities(struct enum_request * req, SaHpiHsCapabilitiesT hs_capabilities)
+{
+        SaHpiTextBufferT buffer;
+        const char * text;
+
+        text = decoded_find(&req->hs_capabilities, hs_capabilities);
+        if (text == NULL) {
+                if (oh_decode_hscapabilities(hs_capabilities, &buffer) != SA_OK)
+                        return "";
+                text = decoded_add(&req->hs_capabilities, req->arena, hs_capabilities, &buffer);
+        }
+        return text;
+}
 
 
-        do {
+/* Inventory row callback that returns the object path of one instance */
+static int return_object_path(void * data, int kind, const struct hpi_inv_row * row)
+{
+        struct enum_request * req = data;
+        CMPIObjectPath * objectpath; /* CIM object path of each new instance of this class */
+        char buf[1024];
 
-                memset(&entry, 0, sizeof(entry));
-                error = saHpiRptEntryGet(hpi_hnd.sid, entry_id, &entry_id, &entry);
+        hpi_device_id(buf, sizeof(buf), row->did, row->rid, row->rdr_type, row->num);
 
-                if (error != SA_OK) {
-                        _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to get HPI RPT data", _CLASSNAME));
-                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI RPT data");
-                }
+        /* Create a new template object path for returning results */
+        objectpath = CMNewObjectPath(_BROKER, req->namespace, req->classname, &req->status);
+        if (req->status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to create new object path - %s",
+                                 _CLASSNAME, CMGetCharPtr(req->status.msg)));
+                return 1;
+        }
+
+        CMAddKey(objectpath, "DeviceID", (CMPIValue *)buf, CMPI_chars);
 
+        CMAddKey(objectpath, "SystemCreationClassName", (CMPIValue *)"Linux_ComputerSystem", CMPI_chars);
 
-                        rdr_id = SAHPI_FIRST_ENTRY;
-                        do {
-                                memset(&rdr, 0, sizeof(rdr));
-                                error = saHpiRdrGet(hpi_hnd.sid, 
-                                                    entry.ResourceId, 
-                                                    rdr_id, 
-                                                    &rdr_id, &rdr);
+        CMAddKey(objectpath, "SystemName", (CMPIValue *)"Laptop", CMPI_chars);
 
-                                if (error != SA_OK) {
-                                        _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to get HPI RDR data", _CLASSNAME));
-                                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI RDR data");
-                                }
+        CMAddKey(objectpath, "CreationClassName", (CMPIValue *)"HPI_LogicalDevice", CMPI_chars);
 
-                                SaHpiDomainInfoT domain_info;
-                                saHpiDomainInfoGet(hpi_hnd.sid, &domain_info);
+        /* Add the object path for this resource to the list of results */
+        CMReturnObjectPath(req->results, objectpath);
+        return 0;
+}
 
-                                rval = management_instrument_id(&rdr);
 
-                                if (rval == -1) 
-                                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Invalid Rdr Type");
-                                
-                                memset(buf, 0, sizeof(buf));
-                                sprintf(buf, "{Domain ID=%d}{Resource ID=%d}{Management Instrument Type=%s}{Management Instrument ID=%d}", 
-                                        domain_info.DomainId,
-                                        entry.ResourceId,
-                                        oh_lookup_rdrtype(rdr.RdrType), 
-                                        (SaHpiInstrumentIdT)rval);
+/* Inventory row callback that returns the full instance data of one instance */
+static int return_instance(void * data, int kind, const struct hpi_inv_row * row)
+{
+        struct enum_request * req = data;
+        CMPIInstance * instance;	/* CIM instance of each new instance of this class */
+        char buf[1024];
+
+        /* Create a new template instance for returning results */
+        /* NB - we create a CIM instance from an existing CIM object path */
+        instance = CMNewInstance(_BROKER, CMNewObjectPath(_BROKER, req->namespace, req->classname, &req->status), &req->status);
+        if (req->status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to create new instance - %s",
+                                 _CLASSNAME, CMGetCharPtr(req->status.msg)));
+                return 1;
+        }
 
-                                /* Create a new template object path for returning results */
-                                objectpath = CMNewObjectPath(_BROKER, namespace, classname, &status);
-                                if (status.rc != CMPI_RC_OK) {
-                                        _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to create new object path - %s",
-                                                         _CLASSNAME, CMGetCharPtr(status.msg)));
-                                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new object path");
-                                }
+        /* Set all the properties of the instance from the inventory columns */
+        /* NB - we're being lazy here and ignore the list of desired properties and just return */
+        /* a predefined set. */
+
+        CMSetProperty(instance, "ElementName", (CMPIValue *)row->tag, CMPI_chars);
+
+        hpi_device_id(buf, sizeof(buf), row->did, row->rid, row->rdr_type, row->num);
+        CMSetProperty(instance, "DeviceID", (CMPIValue *)buf, CMPI_chars);
+
+        CMSetProperty(instance, "SystemCreationClassName", (CMPIValue *)"Linux_ComputerSystem", CMPI_chars);
+        CMSetProperty(instance, "SystemName", (CMPIValue *)"Laptop", CMPI_chars);
+        CMSetProperty(instance, "CreationClassName", (CMPIValue *)"HPI_LogicalDevice", CMPI_chars);
+
+        /* SessionId */
+        CMSetProperty(instance, "SID", (CMPIValue *)&hpi_hnd.sid, CMPI_uint32);
+
+        /* DomainId */
+        CMSetProperty(instance, "DID", (CMPIValue *)&row->did, CMPI_uint32);
+
+        /* ResourceId */
+        CMSetProperty(instance, "RID", (CMPIValue *)&row->rid, CMPI_uint32);
+
+        /* SaHpiResourceInfoT */
+        CMSetProperty(instance, "ResourceRev",
+                      (CMPIValue *)&row->info->ResourceRev, CMPI_uint8);
+        CMSetProperty(instance, "SpecificVer",
+                      (CMPIValue *)&row->info->SpecificVer, CMPI_uint8);
+        CMSetProperty(instance, "DeviceSupport",
+                      (CMPIValue *)&row->info->DeviceSupport, CMPI_uint8);
+        CMSetProperty(instance, "ManufacturerId",
+                      (CMPIValue *)&row->info->ManufacturerId, CMPI_uint32);
+        CMSetProperty(instance, "ProductId",
+                      (CMPIValue *)&row->info->ProductId, CMPI_uint16);
+        CMSetProperty(instance, "FirmwareMajorRev",
+                      (CMPIValue *)&row->info->FirmwareMajorRev, CMPI_uint8);
+        CMSetProperty(instance, "FirmwareMinorRev",
+                      (CMPIValue *)&row->info->FirmwareMinorRev, CMPI_uint8);
+        CMSetProperty(instance, "AuxFirmwareRev",
+                      (CMPIValue *)&row->info->AuxFirmwareRev, CMPI_uint8);
+        CMSetProperty(instance, "Guid",
+                      (CMPIValue *)&row->info->Guid, CMPI_chars);
+
+        /* EntityPath, decoded once per resource change by the inventory */
+        CMSetProperty(instance, "EntityPath",
+                      (CMPIValue *)row->entity_path, CMPI_chars);
+
+        /* Resource Capabilities */
+        CMSetProperty(instance, "Capabilities",
+                      (CMPIValue *)decode_capabilities(req, row->capabilities), CMPI_chars);
+
+        /* SaHpiHsCapabilitiesT */
+        CMSetProperty(instance, "HotSwapCapabilities",
+                      (CMPIValue *)decode_hscapabilities(req, row->hs_capabilities), CMPI_chars);
+
+        /* SaHpiSeverityT */
+        CMSetProperty(instance, "ResourceSeverity",
+                      (CMPIValue *)oh_lookup_severity(row->severity), CMPI_chars);
+
+        /* ResourceFailed */
+        CMSetProperty(instance, "ResourceFailed",
+                      (CMPIValue *)((row->failed == SAHPI_TRUE) ? "TRUE" : "FALSE"),
+                      CMPI_chars);
+
+        /* ResourceTag */
+        CMSetProperty(instance, "ResourceTag", (CMPIValue *)row->tag, CMPI_chars);
+
+        /* Add the instance for this process to the list of results */
+        CMReturnInstance(req->results, instance);
+        return 0;
+}
 
-                                CMAddKey(objectpath, "DeviceID", (CMPIValue *)buf, CMPI_chars);
 
-                                CMAddKey(objectpath, "SystemCreationClassName", (CMPIValue *)"Linux_ComputerSystem", CMPI_chars);
+/* EnumInstanceNames() - return a list of all the instances names (i.e. return their object paths only) */
+static CMPIStatus EnumInstanceNames(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference)	/* [in] Contains the CIM namespace and classname */
+{
+        /* HPI vars */
+        SaErrorT error;
 
-                                CMAddKey(objectpath, "SystemName", (CMPIValue *)"Laptop", CMPI_chars);
+        /* Commonly needed vars */
+        struct enum_request req = { results, NULL, NULL, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
 
-                                CMAddKey(objectpath, "CreationClassName", (CMPIValue *)"HPI_LogicalDevice", CMPI_chars);
+        _OSBASE_TRACE(1,("%s:EnumInstanceNames() called", _CLASSNAME));
 
-                                /* Add the object path for this resource to the list of results */
-                                CMReturnObjectPath(results, objectpath);
-                                
-                        } while (rdr_id != SAHPI_LAST_ENTRY);
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to get HPI RPT data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI RPT data");
+        }
 
-                
-        } while (entry_id != SAHPI_LAST_ENTRY);
+        hpi_inventory_foreach(&hpi_inv, return_object_path, &req);
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new object path");
+        }
 
         /* Finished EnumInstanceNames */
         CMReturnDone(results);
-        _OSBASE_TRACE(1,("%s:EnumInstanceNames() %s", _CLASSNAME, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
-        return status;
+        _OSBASE_TRACE(1,("%s:EnumInstanceNames() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
 }
 
 
@@ -168,209 +322,34 @@ static CMPIStatus EnumInstances(
 {                  
         /* HPI vars */
         SaErrorT error;
-        SaHpiRptEntryT entry;
-        SaHpiEntryIdT entry_id = SAHPI_FIRST_ENTRY;
-
-        SaHpiEntryIdT rdr_id;
-        SaHpiRdrT     rdr;
-
-        oh_big_textbuffer bigbuf;
-
-        char buf[1024];
+        struct hpi_arena arena;
+        HPI_ARENA_BLOCK(DECODED_SCRATCH) scratch;
 
         /* Commonly needed vars */
-        CMPIStatus status = {CMPI_RC_OK, NULL};	/* Return status of CIM operations */
-        CMPIInstance * instance;			/* CIM instance of each new instance of this class */
-        char * namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
-        char * classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+        struct enum_request req = { results, NULL, NULL, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+        req.arena = &arena;
 
         _OSBASE_TRACE(1,("%s:EnumInstances() called", _CLASSNAME));
 
-        do {
-
-
-                error = saHpiRptEntryGet(hpi_hnd.sid, entry_id, &entry_id, &entry);
-        
-                if (error != SA_OK) {
-                        _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to get HPI data", _CLASSNAME));
-                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
-                }
-
-                rdr_id = SAHPI_FIRST_ENTRY;
-                do {
-                        memset(&rdr, 0, sizeof(rdr));
-                        error = saHpiRdrGet(hpi_hnd.sid, 
-                                            entry.ResourceId, 
-                                            rdr_id, 
-                                            &rdr_id, &rdr);
-
-                        /* Create a new template instance for returning results */
-                        /* NB - we create a CIM instance from an existing CIM object path */
-                        instance = CMNewInstance(_BROKER, CMNewObjectPath(_BROKER, namespace, classname, &status), &status);
-                        if (status.rc != CMPI_RC_OK) {
-                                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to create new instance - %s",
-                                                 _CLASSNAME, CMGetCharPtr(status.msg)));
-                                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
-                        }
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
 
-                        /* Set all the properties of the instance from the HPI data */
-                        /* NB - we're being lazy here and ignore the list of desired properties and just return */
-                        /* a predefined set. */
-
-                        CMSetProperty(instance, "RID", (CMPIValue *)&entry.ResourceId, CMPI_uint32);
-                        CMSetProperty(instance, "ElementName", (CMPIValue *)entry.ResourceTag.Data, CMPI_chars);
-
-                        SaHpiDomainInfoT domain_info;
-                        saHpiDomainInfoGet(hpi_hnd.sid, &domain_info);
-
-                        memset(buf, 0, sizeof(buf));
-                        sprintf(buf, "{Domain ID=%d}{Resource ID=%d}{Management Instrument Type=%s}{Management Instrument ID=%d}", 
-                                domain_info.DomainId,
-                                entry.ResourceId,
-                                oh_lookup_rdrtype(rdr.RdrType), 
-                                rdr.RecordId);
-                        
-                        printf("*** DeviceID [%s] ***\n", buf);
-                        CMSetProperty(instance, "DeviceID", 
-                                      (CMPIValue *)buf, CMPI_chars);
-
-                        CMSetProperty(instance, "SystemCreationClassName", (CMPIValue *)"Linux_ComputerSystem", CMPI_chars);
-                        CMSetProperty(instance, "SystemName", (CMPIValue *)"Laptop", CMPI_chars);
-                        CMSetProperty(instance, "CreationClassName", (CMPIValue *)"HPI_LogicalDevice", CMPI_chars);
-
-                        /* SessionId */
-                        printf("*** SId [%d] ***\n", hpi_hnd.sid);
-                        CMSetProperty(instance, "SID", (CMPIValue *)&hpi_hnd.sid, CMPI_uint32);
-
-                        /* DomainId */
-                        printf("*** DId [%d] ***\n", hpi_hnd.domain_info.DomainId);
-                        CMSetProperty(instance, "DID", (CMPIValue *)&hpi_hnd.domain_info.DomainId, CMPI_uint32);
-
-                        /* ResourceId */
-                        printf("*** RId [%d] ***\n", entry.ResourceId);
-                        CMSetProperty(instance, "RID", 
-                                      (CMPIValue *)&entry.ResourceId, CMPI_uint32);
-
-                        /* ResourceRev */
-                        printf("*** ResourceRev [%d] ***\n", 
-                               entry.ResourceInfo.ResourceRev);
-                        CMSetProperty(instance, "ResourceRev", 
-                                      (CMPIValue *)&entry.ResourceInfo.ResourceRev, 
-                                      CMPI_uint8);
-
-                        /* SpecificVer */
-                        printf("*** SpecificVer [%d] ***\n", 
-                               entry.ResourceInfo.SpecificVer);
-                        CMSetProperty(instance, "SpecificVer", 
-                                      (CMPIValue *)&entry.ResourceInfo.SpecificVer, 
-                                      CMPI_uint8);
-
-                        /* DeviceSupport */
-                        printf("*** DeviceSupport [%d] ***\n", 
-                               entry.ResourceInfo.DeviceSupport);
-                        CMSetProperty(instance, "DeviceSupport", 
-                                      (CMPIValue *)&entry.ResourceInfo.DeviceSupport, 
-                                      CMPI_uint8);
-
-                        /* ManufacturerId */
-                        printf("*** ManufacturerId [%d] ***\n", 
-                               entry.ResourceInfo.ManufacturerId);
-                        CMSetProperty(instance, "ManufacturerId", 
-                                      (CMPIValue *)&entry.ResourceInfo.ManufacturerId, 
-                                      CMPI_uint32);
-                        
-                        /* ProductId */
-                        printf("*** ProductId [%d] ***\n", 
-                               entry.ResourceInfo.ProductId);
-                        CMSetProperty(instance, "ProductId", 
-                                      (CMPIValue *)&entry.ResourceInfo.ProductId, 
-                                      CMPI_uint16);
-
-                        /* FirmwareMajorRev */
-                        printf("*** FirmwareMajorRev [%d] ***\n", 
-                               entry.ResourceInfo.FirmwareMajorRev);
-                        CMSetProperty(instance, "FirmwareMajorRev", 
-                                      (CMPIValue *)&entry.ResourceInfo.FirmwareMajorRev, 
-                                      CMPI_uint8);
-
-                        /* FirmwareMinorRev */
-                        printf("*** FirmwareMinorRev [%d] ***\n", 
-                               entry.ResourceInfo.FirmwareMinorRev);
-                        CMSetProperty(instance, "FirmwareMinorRev", 
-                                      (CMPIValue *)&entry.ResourceInfo.FirmwareMinorRev, 
-                                      CMPI_uint8);
-
-                        /* AuxFirmwareRev */
-                        printf("*** AuxFirmwareRev [%d] ***\n", 
-                               entry.ResourceInfo.AuxFirmwareRev);
-                        CMSetProperty(instance, "AuxFirmwareRev", 
-                                      (CMPIValue *)&entry.ResourceInfo.AuxFirmwareRev, 
-                                      CMPI_uint8);
-
-                        /* Guid */
-                        printf("*** Guid [%d] ***\n", 
-                               entry.ResourceInfo.Guid);
-                        CMSetProperty(instance, "Guid", 
-                                      (CMPIValue *)&entry.ResourceInfo.Guid,
-                                      CMPI_chars);
-
-                        /* EntityPath */
-                        //                oh_big_textbuffer bigbuf;
-                        //                memset(&bigbuf, 0, sizeof(bigbuf));
-                        //                error = oh_decode_entitypath(&entry.ResourceEntity, &bigbuf);
-                        memset(&bigbuf, 0, sizeof(bigbuf));
-                        error = oh_decode_entitypath(&entry.ResourceEntity, &bigbuf);                        
-                        printf("*** EntityPath [%s] ***\n", bigbuf.Data);
-                        CMSetProperty(instance, "EntityPath", 
-                                      (CMPIValue *)bigbuf.Data, CMPI_chars);
-
-                        /* Resource Capabilities */
-                        SaHpiTextBufferT buffer;
-                        memset(&buffer, 0, sizeof(buffer));
-                        printf("*** Capabilities [%s] ***\n", buffer.Data);
-                        error = oh_decode_capabilities(entry.ResourceCapabilities, 
-                                                       &buffer);
-                        CMSetProperty(instance, "Capabilities", 
-                                      (CMPIValue *)buffer.Data, CMPI_chars);
-
-                        /* SaHpiHsCapabilitiesT */
-                        memset(&buffer, 0, sizeof(buffer));
-                        error = oh_decode_hscapabilities(entry.HotSwapCapabilities,
-                                                 &buffer);
-                        printf("*** HotSwapCapabilities [%s] ***\n", buffer.Data);
-                        CMSetProperty(instance, "HotSwapCapabilities", 
-                                      (CMPIValue *)buffer.Data, CMPI_chars);
-
-                        /* SaHpiSeverityT */
-                        printf("*** ResourceSeverity [%s] ***\n", 
-                               oh_lookup_severity(entry.ResourceSeverity));
-                        CMSetProperty(instance, "ResourceSeverity", 
-                                      (CMPIValue *)oh_lookup_severity(entry.ResourceSeverity), 
-                                      CMPI_chars);
-
-                        /* ResourceFailed */
-                        printf("*** ResourceSeverity [%s] ***\n", 
-                               (entry.ResourceFailed == SAHPI_TRUE) ? "TRUE" : "FALSE");
-                        CMSetProperty(instance, "ResourceFailed", 
-                                      (CMPIValue *)(entry.ResourceFailed == SAHPI_TRUE) 
-                                                ? "TRUE" : "FALSE", 
-                                      CMPI_chars);
-                        
-                        /* ResourceTag */
-                        CMSetProperty(instance, "ResourceTag", 
-                                      (CMPIValue *)entry.ResourceTag.Data, CMPI_chars);
-
-                        /* Add the instance for this process to the list of results */
-                        CMReturnInstance(results, instance);
-
-                } while ( rdr_id != SAHPI_LAST_ENTRY );
-
-        } while (entry_id != SAHPI_LAST_ENTRY);
+        hpi_arena_init(&arena, scratch.data, sizeof(scratch.data));
+        hpi_inventory_foreach(&hpi_inv, return_instance, &req);
+        hpi_arena_reset(&arena);
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
 
         /* Finished EnumInstances */
         CMReturnDone(results);
-        _OSBASE_TRACE(1,("%s:EnumInstances() %s", _CLASSNAME, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
-        return status;
+        _OSBASE_TRACE(1,("%s:EnumInstances() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
 }
 
 
@@ -499,7 +478,39 @@ static CMPIStatus DeleteInstance(
 }
 
 
+/* Strip the '%' from a LIKE pattern of the form '<path>%'. Other wildcards
+ * and escapes are refused rather than matched literally. The one exception
+ * is '_' inside an entity type name: the path must still encode to known
+ * entity types, and none of their names differs from another only there. */
+static int like_prefix(char * pattern)
+{
+        size_t len = strlen(pattern);
+        int in_name = 0;
+        char * p;
+
+        if (len == 0 || pattern[len - 1] != '%')
+                return -1;
+        pattern[len - 1] = '\0';
+
+        for (p = pattern; *p; p++) {
+                if (*p == '{')
+                        in_name = 1;
+                else if (*p == ',' || *p == '}')
+                        in_name = 0;
+                else if (*p == '%' || *p == '[' || *p == '\\' || (*p == '_' && !in_name))
+                        return -1;
+        }
+        return 0;
+}
+
+
 /* ExecQuery() - return a list of all the instances that 'satisfy' the desired query filter */
+/* Only entity path selections are supported, served from the inventory's entity path trie:
+ *      SELECT * FROM HPI_LogicalDevice WHERE EntityPath = '{SYSTEM_CHASSIS,2}{SBC_BLADE,7}'
+ *      SELECT * FROM HPI_LogicalDevice WHERE EntityPath LIKE '{SYSTEM_CHASSIS,2}%'
+ * A trailing '%' selects the whole subtree under the given path, element by element, so
+ * '{SYSTEM_CHASSIS,2}%' does not match chassis 23. Any other LIKE pattern is refused
+ * with CMPI_RC_ERR_NOT_SUPPORTED, see like_prefix(). */
 static CMPIStatus ExecQuery(
 		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
 		CMPIContext * context,		/* [in] Additional context info, if any */
@@ -508,18 +519,78 @@ static CMPIStatus ExecQuery(
 		char * language,		/* [in] Name of the query language (e.g. "WQL") */ 
 		char * query)			/* [in] Text of the query, written in the query language */ 
 {
-        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
-        
+        /* HPI vars */
+        SaErrorT error;
+        SaHpiEntityPathT ep;
+
+        /* Query vars */
+        struct hpi_query q;
+        struct hpi_query_cond * cond;
+        int descend = 0;
+        struct hpi_arena arena;
+        HPI_ARENA_BLOCK(DECODED_SCRATCH) scratch;
+
+        /* Commonly needed vars */
+        struct enum_request req = { results, NULL, NULL, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+        req.arena = &arena;
+
         _OSBASE_TRACE(1,("%s:ExecQuery() called", self->ft->miName));
-        
-        /* Query filtering is not supported for this class */                                                                                                                         
+
+        if (hpi_query_parse(language, query, &q) != 0 ||
+            strcasecmp(q.classname, _CLASSNAME) != 0) {
+                _OSBASE_TRACE(1,("%s:ExecQuery() : Unsupported query - %s", self->ft->miName, query));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_INVALID_QUERY, "Unsupported query");
+        }
+
+        cond = hpi_query_find(&q, "EntityPath");
+        if (q.ncond > 1 || (q.ncond == 1 && cond == NULL)) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_SUPPORTED, "Only EntityPath can be queried");
+        }
+
+        memset(&ep, 0, sizeof(ep));
+        if (cond != NULL) {
+                if (!cond->is_string) {
+                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_INVALID_QUERY, "EntityPath takes a quoted string");
+                }
+                if (cond->op == HPI_QUERY_LIKE) {
+                        if (like_prefix(cond->value) != 0) {
+                                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_SUPPORTED, "Only LIKE '<path>%' is supported");
+                        }
+                        descend = 1;
+                } else if (cond->op != HPI_QUERY_EQ) {
+                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_SUPPORTED, "Only = and LIKE are supported on EntityPath");
+                }
+                if (cond->value[0] == '\0') {
+                        ep.Entry[0].EntityType = SAHPI_ENT_ROOT;
+                } else if (oh_encode_entitypath(cond->value, &ep) != SA_OK) {
+                        CMReturnWithChars(_BROKER, CMPI_RC_ERR_INVALID_QUERY, "Invalid EntityPath");
+                }
+        }
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:ExecQuery() : Failed to get HPI data", self->ft->miName));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+
+        hpi_arena_init(&arena, scratch.data, sizeof(scratch.data));
+        if (cond == NULL)
+                hpi_inventory_foreach(&hpi_inv, return_instance, &req);
+        else
+                hpi_inventory_subtree(&hpi_inv, &ep, descend, return_instance, &req);
+        hpi_arena_reset(&arena);
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
+
         /* Finished */
         CMReturnDone(results);
 
-        /* Not implemented, yet... */
         _OSBASE_TRACE(1,("%s:ExecQuery() %s",
-                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
-        return status;
+                      self->ft->miName, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
 }
 
 
@@ -541,6 +612,155 @@ static CMPIStatus Cleanup(
 }
 
 
+/* ---------------------------------------------------------------------------
+ * CMPI METHOD PROVIDER FUNCTIONS
+ * --------------------------------------------------------------------------- */
+
+/* DeviceIDs collected by GetChanges(), one list per kind of change */
+struct change_list {
+        char **ids;
+        unsigned int count;
+        unsigned int size;
+        int failed;
+        struct hpi_arena *arena;        /* holds the DeviceID strings */
+};
+
+static int collect_change(void *data, int kind, const struct hpi_inv_row *row)
+{
+        struct change_list *list = (struct change_list *)data + (kind - HPI_INV_ADDED);
+        char buf[1024];
+        char **ids;
+        int len;
+
+        if (list->count == list->size) {
+                list->size = list->size ? list->size * 2 : 64;
+                ids = realloc(list->ids, list->size * sizeof(*ids));
+                if (ids == NULL) {
+                        list->size = list->count;
+                        list->failed = 1;
+                        return 1;
+                }
+                list->ids = ids;
+        }
+
+        len = hpi_device_id(buf, sizeof(buf), row->did, row->rid, row->rdr_type, row->num);
+        if (len >= (int)sizeof(buf))
+                len = sizeof(buf) - 1;
+        list->ids[list->count] = hpi_arena_strndup(list->arena, buf, len);
+        if (list->ids[list->count] == NULL) {
+                list->failed = 1;
+                return 1;
+        }
+        list->count++;
+        return 0;
+}
+
+
+/* Turn a list of DeviceIDs into a CIM string array output argument, freeing the list.
+ * The strings themselves go with the request's arena. */
+static CMPIStatus return_change_list(CMPIArgs * argsout, char * name, struct change_list * list)
+{
+        CMPIStatus status = {CMPI_RC_OK, NULL};
+        CMPIArray * array;
+        unsigned int i;
+
+        array = CMNewArray(_BROKER, list->count, CMPI_string, &status);
+        for (i = 0; i < list->count && status.rc == CMPI_RC_OK; i++)
+                CMSetArrayElementAt(array, i, (CMPIValue *)list->ids[i], CMPI_chars);
+        free(list->ids);
+
+        if (status.rc == CMPI_RC_OK)
+                CMAddArg(argsout, name, (CMPIValue *)&array, CMPI_stringA);
+        return status;
+}
+
+
+/* InvokeMethod() - invoke an extrinsic method of this class */
+static CMPIStatus InvokeMethod(
+		CMPIMethodMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		char * methodname,		/* [in] Name of the method to invoke */
+		CMPIArgs * argsin,		/* [in] Method input arguments */
+		CMPIArgs * argsout)		/* [out] Method output arguments */
+{
+        CMPIStatus status = {CMPI_RC_OK, NULL};	/* Return status of CIM operations */
+        struct change_list changes[3];
+        struct hpi_arena arena;
+        HPI_ARENA_BLOCK(CHANGES_SCRATCH) scratch;
+        CMPIData sinceData;
+        SaHpiUint64T since, generation;
+        CMPIBoolean resync;
+        CMPIUint32 rc = 0;
+        SaErrorT error;
+        int i;
+
+        _OSBASE_TRACE(1,("%s:InvokeMethod() called", _CLASSNAME));
+
+        if (strcasecmp(methodname, "GetChanges") != 0) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_METHOD_NOT_FOUND, methodname);
+        }
+
+        /* A missing or NULL token asks for the full inventory */
+        since = 0;
+        sinceData = CMGetArg(argsin, "Generation", NULL);
+        if (!CMIsNullValue(sinceData))
+                since = sinceData.value.uint64;
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:InvokeMethod() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+
+        hpi_arena_init(&arena, scratch.data, sizeof(scratch.data));
+        memset(changes, 0, sizeof(changes));
+        for (i = 0; i < 3; i++)
+                changes[i].arena = &arena;
+        resync = hpi_inventory_changes(&hpi_inv, since, &generation,
+                                       collect_change, changes);
+
+        CMAddArg(argsout, "NewGeneration", (CMPIValue *)&generation, CMPI_uint64);
+        CMAddArg(argsout, "Resync", (CMPIValue *)&resync, CMPI_boolean);
+        for (i = 0; i < 3; i++) {
+                if (changes[i].failed)
+                        status.rc = CMPI_RC_ERR_FAILED;
+                if (return_change_list(argsout, _CHANGENAMES[i], &changes[i]).rc != CMPI_RC_OK)
+                        status.rc = CMPI_RC_ERR_FAILED;
+        }
+        hpi_arena_reset(&arena);
+        if (status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:InvokeMethod() : Failed to create output arguments", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create output arguments");
+        }
+
+        CMReturnData(results, (CMPIValue *)&rc, CMPI_uint32);
+        CMReturnDone(results);
+
+        _OSBASE_TRACE(1,("%s:InvokeMethod() %s", _CLASSNAME, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* MethodCleanup() - perform any necessary cleanup immediately before this provider is unloaded */
+static CMPIStatus MethodCleanup(
+		CMPIMethodMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context)		/* [in] Additional context info, if any */
+{
+        CMPIStatus status = {CMPI_RC_OK, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:MethodCleanup() called", self->ft->miName));
+
+        /* Nothing needs to be done for cleanup */
+
+        /* Finished */
+
+        _OSBASE_TRACE(1,("%s:MethodCleanup() %s", self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
 /* OPTIONAL: Initialize() is *NOT* a predefined CMPI method. See CMInstanceMIStub() below */
 static void Initialize(
 		CMPIBroker *broker)		/* [in] Handle to the CIMOM */                
@@ -549,24 +769,16 @@ static void Initialize(
    
         _OSBASE_TRACE(1,("%s:Initialize() called", _CLASSNAME)); 
 
-        error = saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &(hpi_hnd.sid), 0);
-        if (error) {
-                hpi_hnd.sid = 0;
-                _OSBASE_TRACE(1,("%s:Initialize() failed", _CLASSNAME));
-                return;
-        }
-
-        error = saHpiDomainInfoGet (hpi_hnd.sid, &(hpi_hnd.domain_info));
+        /* All the providers in this library share one session */
+        error = hpi_session_open();
         if (error) {
-                hpi_hnd.sid = 0;
-                _OSBASE_TRACE(1,("%s:saHpiDomainInfoGet() failed", _CLASSNAME));
+                _OSBASE_TRACE(1,("%s:hpi_session_open() failed", _CLASSNAME));
                 return;
         }
 
-        error = saHpiDiscover(hpi_hnd.sid);
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
         if (error) {
-                _OSBASE_TRACE(1,("%s:saHpiDiscover() failed", _CLASSNAME));
-                return;
+                _OSBASE_TRACE(1,("%s:hpi_inventory_refresh() failed", _CLASSNAME));
         }
         
         /* Nothing needs to be done */
@@ -589,6 +801,10 @@ static void Initialize(
      loading the provider. Specify "CMNoHook" if not required. */
 CMInstanceMIStub( , HPI_LogicalDeviceProvider, _BROKER, Initialize(_BROKER));
 
+/* Same parameters for the method provider, which supplies GetChanges(). The
+   function table entries are MethodCleanup() and InvokeMethod(). */
+CMMethodMIStub( , HPI_LogicalDeviceProvider, _BROKER, Initialize(_BROKER));
+
 /* If no special initialization is required then remove the Initialize() function and use:
 CMInstanceMIStub( , CWS_ProcessProvider, _BROKER, CMNoHook);
 */
@@ -0,0 +1,444 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+/* Name of this provider */
+static char _CLASSNAME[] = "HPI_Inventory";
+
+#define CMPI_VERSION 90
+
+/* Include the required C library headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/* Include the required CMPI macros, data types, and API function headers */
+#include "cmpidt.h"
+#include "cmpift.h"
+#include "cmpimacs.h"
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include <hpi_utils.h>
+#include <hpi_inventory.h>
+#include <hpi_idr.h>
+
+/* IDR field properties, indexed by SaHpiIdrFieldTypeT */
+static char * _FIELDNAMES[] = {"ChassisType", "ManufactureDate", "Manufacturer",
+                               "ProductName", "ProductVersion", "SerialNumber",
+                               "PartNumber", "FileId", "AssetTag", NULL};
+
+/* Simple logging facility, in case the standard SBLIM _OSBASE_TRACE() isn't available */
+#ifndef _OSBASE_TRACE
+#include <stdarg.h>
+#define _OSBASE_TRACE(x,y) _logstderr y
+static void _logstderr(char *fmt,...)
+{
+   va_list ap;
+   va_start(ap,fmt);
+   vfprintf(stderr,fmt,ap);
+   va_end(ap);
+   fprintf(stderr,"\n");
+}
+#endif
+
+
+/* Handle to the CIM broker. This is initialized by the CIMOM when the provider is loaded */
+static CMPIBroker * _BROKER;
+
+
+/* Map the requested properties to the IDR field types that must be fetched */
+static unsigned int field_mask(char ** properties)
+{
+        unsigned int fields = 0;
+        int i, type;
+
+        if (properties == NULL)
+                return HPI_IDR_ALL_FIELDS;
+
+        for (i = 0; properties[i] != NULL; i++)
+                for (type = 0; _FIELDNAMES[type] != NULL; type++)
+                        if (strcasecmp(properties[i], _FIELDNAMES[type]) == 0)
+                                fields |= HPI_IDR_FIELD(type);
+        return fields;
+}
+
+
+/* Per-request state handed to the row and IDR callbacks below */
+struct inventory_request {
+        CMPIResult * results;
+        char * namespace;
+        char * classname;
+        SaHpiDomainIdT did;
+        CMPIStatus status;
+};
+
+
+/* Row callback that returns the object path of one inventory RDR */
+static int return_object_path(void * data, int kind, const struct hpi_inv_row * row)
+{
+        struct inventory_request * req = data;
+        CMPIObjectPath * objectpath;
+        char buf[1024];
+
+        objectpath = CMNewObjectPath(_BROKER, req->namespace, req->classname, &req->status);
+        if (req->status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to create new object path - %s",
+                                 _CLASSNAME, CMGetCharPtr(req->status.msg)));
+                return 1;
+        }
+
+        hpi_device_id(buf, sizeof(buf), row->did, row->rid, SAHPI_INVENTORY_RDR, row->num);
+        CMAddKey(objectpath, "DeviceID", (CMPIValue *)buf, CMPI_chars);
+
+        CMReturnObjectPath(req->results, objectpath);
+        return 0;
+}
+
+
+/* IDR callback that returns the instance data of one IDR. Fields that were
+ * not requested, or that the IDR does not have, are left NULL. */
+static int return_instance(void * data, const struct hpi_idr * idr)
+{
+        struct inventory_request * req = data;
+        CMPIInstance * instance;
+        CMPIBoolean readonly;
+        char buf[1024];
+        int type;
+
+        instance = CMNewInstance(_BROKER, CMNewObjectPath(_BROKER, req->namespace, req->classname, &req->status), &req->status);
+        if (req->status.rc != CMPI_RC_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to create new instance - %s",
+                                 _CLASSNAME, CMGetCharPtr(req->status.msg)));
+                return 1;
+        }
+
+        hpi_device_id(buf, sizeof(buf), req->did, idr->rid, SAHPI_INVENTORY_RDR, idr->idrid);
+        CMSetProperty(instance, "DeviceID", (CMPIValue *)buf, CMPI_chars);
+        CMSetProperty(instance, "DID", (CMPIValue *)&req->did, CMPI_uint32);
+        CMSetProperty(instance, "RID", (CMPIValue *)&idr->rid, CMPI_uint32);
+        CMSetProperty(instance, "IdrId", (CMPIValue *)&idr->idrid, CMPI_uint32);
+
+        /* IdrInfo */
+        CMSetProperty(instance, "UpdateCount", (CMPIValue *)&idr->info.UpdateCount, CMPI_uint32);
+        CMSetProperty(instance, "NumAreas", (CMPIValue *)&idr->info.NumAreas, CMPI_uint32);
+        readonly = idr->info.ReadOnly ? 1 : 0;
+        CMSetProperty(instance, "ReadOnly", (CMPIValue *)&readonly, CMPI_boolean);
+
+        /* Fields */
+        for (type = 0; _FIELDNAMES[type] != NULL; type++)
+                if (idr->present & HPI_IDR_FIELD(type))
+                        CMSetProperty(instance, _FIELDNAMES[type],
+                                      (CMPIValue *)idr->field[type], CMPI_chars);
+
+        CMReturnInstance(req->results, instance);
+        return 0;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * CMPI INSTANCE PROVIDER FUNCTIONS
+ * --------------------------------------------------------------------------- */
+
+/* EnumInstanceNames() - return a list of all the instances names (i.e. return their object paths only) */
+/* The names come from the inventory RDRs alone, no IDR is read */
+static CMPIStatus EnumInstanceNames(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference)	/* [in] Contains the CIM namespace and classname */
+{
+        SaErrorT error;
+        struct inventory_request req = { results, NULL, NULL, 0, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:EnumInstanceNames() called", _CLASSNAME));
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstanceNames() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+
+        hpi_inventory_foreach_type(&hpi_inv, SAHPI_INVENTORY_RDR, return_object_path, &req);
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new object path");
+        }
+
+        /* Finished EnumInstanceNames */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:EnumInstanceNames() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* EnumInstances() - return a list of all the instances (i.e. return all their instance data) */
+/* Only the IDR fields named in 'properties' are fetched, and only if not already cached */
+static CMPIStatus EnumInstances(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace and classname */
+		char ** properties)		/* [in] List of desired properties (NULL=all) */
+{
+        SaErrorT error;
+        struct hpi_idr_key * keys;
+        unsigned int fields;
+        int i, n;
+        struct inventory_request req = { results, NULL, NULL, 0, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:EnumInstances() called", _CLASSNAME));
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+        req.did = hpi_inventory_domain(&hpi_inv);
+
+        /* List the IDRs first so the inventory is not locked while they are read */
+        n = hpi_idr_keys(&hpi_inv, &keys);
+        if (n < 0) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Out of memory");
+        }
+
+        fields = field_mask(properties);
+        for (i = 0; i < n; i++) {
+                error = hpi_idr_get(&hpi_idrs, &hpi_inv, hpi_hnd.sid, keys[i].rid,
+                                    keys[i].idrid, fields, return_instance, &req);
+                if (req.status.rc != CMPI_RC_OK)
+                        break;
+                /* An IDR that went away since the refresh is simply skipped */
+                if (error != SA_OK) {
+                        _OSBASE_TRACE(1,("%s:EnumInstances() : Failed to read IDR %d of resource %d",
+                                         _CLASSNAME, keys[i].idrid, keys[i].rid));
+                }
+        }
+        free(keys);
+
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
+
+        /* Finished EnumInstances */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:EnumInstances() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* GetInstance() -  return the instance data for the specified instance only */
+static CMPIStatus GetInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		char ** properties)		/* [in] List of desired properties (NULL=all) */
+{
+        SaErrorT error;
+        CMPIData idData;
+        SaHpiDomainIdT did;
+        SaHpiResourceIdT rid;
+        SaHpiIdrIdT idrid;
+        char type[64];
+        struct inventory_request req = { results, NULL, NULL, 0, {CMPI_RC_OK, NULL} };
+        req.namespace = CMGetCharPtr(CMGetNameSpace(reference, NULL)); /* Our current CIM namespace */
+        req.classname = CMGetCharPtr(CMGetClassName(reference, NULL)); /* Registered name of this CIM class */
+
+        _OSBASE_TRACE(1,("%s:GetInstance() called", _CLASSNAME));
+
+        idData = CMGetKey(reference, "DeviceID", &req.status);
+        if (req.status.rc != CMPI_RC_OK || CMIsNullValue(idData)) {
+                _OSBASE_TRACE(1,("%s:GetInstance() : Cannot determine desired IDR", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Cannot determine desired IDR");
+        }
+
+        if (sscanf(CMGetCharPtr(idData.value.string),
+                   "{Domain ID=%u}{Resource ID=%u}{Management Instrument Type=%63[^}]}{Management Instrument ID=%u}",
+                   &did, &rid, type, &idrid) != 4 ||
+            strcmp(type, oh_lookup_rdrtype(SAHPI_INVENTORY_RDR)) != 0) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "Invalid DeviceID");
+        }
+
+        /* Only IDRs of inventory RDRs present in the inventory are looked up */
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:GetInstance() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+        if (did != hpi_inventory_domain(&hpi_inv)) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "No such domain");
+        }
+        req.did = did;
+
+        error = hpi_idr_get(&hpi_idrs, &hpi_inv, hpi_hnd.sid, rid, idrid,
+                            field_mask(properties), return_instance, &req);
+        if (error == SA_ERR_HPI_NOT_PRESENT || error == SA_ERR_HPI_INVALID_RESOURCE ||
+            error == SA_ERR_HPI_CAPABILITY) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_NOT_FOUND, "No such IDR");
+        }
+        if (error != SA_OK) {
+                _OSBASE_TRACE(1,("%s:GetInstance() : Failed to get HPI data", _CLASSNAME));
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to get HPI data");
+        }
+        if (req.status.rc != CMPI_RC_OK) {
+                CMReturnWithChars(_BROKER, CMPI_RC_ERR_FAILED, "Failed to create new instance");
+        }
+
+        /* Finished */
+        CMReturnDone(results);
+        _OSBASE_TRACE(1,("%s:GetInstance() %s", _CLASSNAME, (req.status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return req.status;
+}
+
+
+/* SetInstance() - save modified instance data for the specified instance */
+static CMPIStatus SetInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		CMPIInstance * newinstance)	/* [in] Contains all the new instance data */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:SetInstance() called", self->ft->miName));
+
+        /* Modifying existing instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:SetInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* CreateInstance() - create a new instance from the specified instance data */
+static CMPIStatus CreateInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace, classname and desired object path */
+		CMPIInstance * newinstance)	/* [in] Contains all the new instance data */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:CreateInstance() called", self->ft->miName));
+
+        /* Creating new instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:CreateInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* DeleteInstance() - delete/remove the specified instance */
+static CMPIStatus DeleteInstance(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference)	/* [in] Contains the CIM namespace, classname and desired object path */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:DeleteInstance() called", self->ft->miName));
+
+        /* Deleting instances is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:DeleteInstance() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* ExecQuery() - return a list of all the instances that 'satisfy' the desired query filter */
+static CMPIStatus ExecQuery(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context,		/* [in] Additional context info, if any */
+		CMPIResult * results,		/* [out] Results of this operation */
+		CMPIObjectPath * reference,	/* [in] Contains the CIM namespace and classname */
+		char * language,		/* [in] Name of the query language (e.g. "WQL") */
+		char * query)			/* [in] Text of the query, written in the query language */
+{
+        CMPIStatus status = {CMPI_RC_ERR_NOT_SUPPORTED, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:ExecQuery() called", self->ft->miName));
+
+        /* Query filtering is not supported for this class */
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:ExecQuery() %s",
+                      self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* Cleanup() - perform any necessary cleanup immediately before this provider is unloaded */
+static CMPIStatus Cleanup(
+		CMPIInstanceMI * self,		/* [in] Handle to this provider (i.e. 'self') */
+		CMPIContext * context)		/* [in] Additional context info, if any */
+{
+        CMPIStatus status = {CMPI_RC_OK, NULL};	/* Return status of CIM operations */
+
+        _OSBASE_TRACE(1,("%s:Cleanup() called", self->ft->miName));
+
+        /* The background fill must not outlive the library */
+        hpi_idr_fill_stop(&hpi_idrs);
+
+        /* Finished */
+        _OSBASE_TRACE(1,("%s:Cleanup() %s", self->ft->miName, (status.rc == CMPI_RC_OK)? "succeeded":"failed"));
+        return status;
+}
+
+
+/* OPTIONAL: Initialize() is *NOT* a predefined CMPI method. See CMInstanceMIStub() below */
+static void Initialize(
+		CMPIBroker *broker)		/* [in] Handle to the CIMOM */
+{
+        SaErrorT error = SA_OK;
+
+        _OSBASE_TRACE(1,("%s:Initialize() called", _CLASSNAME));
+
+        /* All the providers in this library share one session and one inventory */
+        error = hpi_session_open();
+        if (error) {
+                _OSBASE_TRACE(1,("%s:hpi_session_open() failed", _CLASSNAME));
+                return;
+        }
+
+        error = hpi_inventory_refresh(&hpi_inv, hpi_hnd.sid);
+        if (error) {
+                _OSBASE_TRACE(1,("%s:hpi_inventory_refresh() failed", _CLASSNAME));
+                return;
+        }
+
+        /* Read the IDRs found by discovery ahead of the first request */
+        if (hpi_idr_fill_start(&hpi_idrs, hpi_hnd.sid)) {
+                _OSBASE_TRACE(1,("%s:hpi_idr_fill_start() failed", _CLASSNAME));
+        }
+
+        _OSBASE_TRACE(1,("%s:Initialize() succeeded", _CLASSNAME));
+}
+
+
+/* ---------------------------------------------------------------------------
+ * CMPI PROVIDER SETUP
+ * --------------------------------------------------------------------------- */
+
+/* See Hpi.c for a description of the factory parameters */
+CMInstanceMIStub( , HPI_InventoryProvider, _BROKER, Initialize(_BROKER));
@@ -0,0 +1,83 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <hpi_arena.h>
+
+#define ALIGN(n)        (((n) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/* Start an arena on 'block', which may be NULL */
+void hpi_arena_init(struct hpi_arena *arena, void *block, size_t size)
+{
+        arena->first = block;
+        arena->first_size = block ? size : 0;
+        arena->block = arena->first;
+        arena->size = arena->first_size;
+        arena->used = 0;
+        arena->chunks = NULL;
+}
+
+/* Allocate 'len' bytes, aligned for any pointer. The memory is not cleared.
+ * Returns NULL if out of memory. */
+void *hpi_arena_alloc(struct hpi_arena *arena, size_t len)
+{
+        struct hpi_arena_chunk *chunk;
+        size_t start, size;
+
+        start = ALIGN(arena->used);
+        if (arena->block != NULL && start + len <= arena->size) {
+                arena->used = start + len;
+                return arena->block + start;
+        }
+
+        size = len > HPI_ARENA_CHUNK ? len : HPI_ARENA_CHUNK;
+        chunk = malloc(sizeof(*chunk) + size);
+        if (chunk == NULL)
+                return NULL;
+        chunk->next = arena->chunks;
+        chunk->size = size;
+        arena->chunks = chunk;
+
+        arena->block = chunk->data;
+        arena->size = size;
+        arena->used = len;
+        return chunk->data;
+}
+
+/* Copy 'len' bytes of 'str' and terminate them */
+char *hpi_arena_strndup(struct hpi_arena *arena, const char *str, size_t len)
+{
+        char *copy;
+
+        copy = hpi_arena_alloc(arena, len + 1);
+        if (copy == NULL)
+                return NULL;
+        memcpy(copy, str, len);
+        copy[len] = '\0';
+        return copy;
+}
+
+/* Drop every allocation and go back to the caller's block */
+void hpi_arena_reset(struct hpi_arena *arena)
+{
+        struct hpi_arena_chunk *chunk;
+
+        while ((chunk = arena->chunks) != NULL) {
+                arena->chunks = chunk->next;
+                free(chunk);
+        }
+        arena->block = arena->first;
+        arena->size = arena->first_size;
+        arena->used = 0;
+}
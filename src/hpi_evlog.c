@@ -0,0 +1,330 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <SaHpi.h>
+#include <hpi_inventory.h>
+#include <hpi_evlog.h>
+
+struct hpi_evlog_cache hpi_evlogs = { PTHREAD_MUTEX_INITIALIZER };
+
+static struct hpi_evlog *log_lookup(struct hpi_evlog_cache *c, SaHpiResourceIdT rid)
+{
+        struct hpi_evlog *log;
+        unsigned int i, size;
+
+        for (i = 0; i < c->count; i++)
+                if (c->log[i].rid == rid)
+                        return &c->log[i];
+
+        if (c->count == c->size) {
+                size = c->size ? c->size * 2 : 8;
+                log = realloc(c->log, size * sizeof(*log));
+                if (log == NULL)
+                        return NULL;
+                c->log = log;
+                c->size = size;
+        }
+        log = &c->log[c->count++];
+        memset(log, 0, sizeof(*log));
+        log->rid = rid;
+        return log;
+}
+
+/* Drop the logs of the resources that went away or lost the EVENT_LOG
+ * capability. 'rids' lists the capable resources as of 'generation'. */
+static void log_sweep(struct hpi_evlog_cache *c,
+                      SaHpiUint64T generation,
+                      const SaHpiResourceIdT *rids,
+                      int n)
+{
+        unsigned int i, count;
+        int j;
+
+        if (generation == c->generation)
+                return;
+
+        for (i = 0, count = 0; i < c->count; i++) {
+                for (j = 0; j < n && rids[j] != c->log[i].rid; j++)
+                        ;
+                if (c->log[i].rid != SAHPI_UNSPECIFIED_RESOURCE_ID && j == n) {
+                        free(c->log[i].ring);
+                        continue;
+                }
+                if (count != i)
+                        c->log[count] = c->log[i];
+                count++;
+        }
+        c->count = count;
+        c->generation = generation;
+}
+
+static void ring_reset(struct hpi_evlog *log)
+{
+        log->head = 0;
+        log->count = 0;
+        log->truncated = SAHPI_FALSE;
+}
+
+/* Append an entry, dropping the oldest once HPI_EVLOG_MAX_ENTRIES are kept */
+static int ring_push(struct hpi_evlog *log, const struct hpi_evlog_entry *entry)
+{
+        struct hpi_evlog_entry *ring;
+        unsigned int size, i;
+
+        if (log->count == log->size && log->size < HPI_EVLOG_MAX_ENTRIES) {
+                size = log->size ? log->size * 2 : 64;
+                if (size > HPI_EVLOG_MAX_ENTRIES)
+                        size = HPI_EVLOG_MAX_ENTRIES;
+                ring = malloc(size * sizeof(*ring));
+                if (ring == NULL)
+                        return -1;
+                for (i = 0; i < log->count; i++)
+                        ring[i] = log->ring[(log->head + i) % log->size];
+                free(log->ring);
+                log->ring = ring;
+                log->size = size;
+                log->head = 0;
+        }
+
+        if (log->count == log->size) {
+                log->ring[log->head] = *entry;
+                log->head = (log->head + 1) % log->size;
+                log->truncated = SAHPI_TRUE;
+        } else {
+                log->ring[(log->head + log->count) % log->size] = *entry;
+                log->count++;
+        }
+        return 0;
+}
+
+/* Read the entries added since the high-water mark. Nothing is read while
+ * the log's UpdateTimestamp is unchanged. If the mark entry is gone or was
+ * replaced, the log was cleared or wrapped and is read again from the
+ * oldest entry. */
+static SaErrorT log_sync(SaHpiSessionIdT sid, struct hpi_evlog *log)
+{
+        SaHpiEventLogInfoT info;
+        SaHpiEventLogEntryT hpi;
+        SaHpiEventLogEntryIdT id, prev, next;
+        struct hpi_evlog_entry entry, *newest;
+        SaErrorT error;
+
+        error = saHpiEventLogInfoGet(sid, log->rid, &info);
+        if (error)
+                return error;
+        if (log->synced && info.UpdateTimestamp == log->update_timestamp)
+                return SA_OK;
+
+        id = SAHPI_OLDEST_ENTRY;
+        if (log->count) {
+                newest = &log->ring[(log->head + log->count - 1) % log->size];
+                error = saHpiEventLogEntryGet(sid, log->rid, newest->entry_id,
+                                              &prev, &next, &hpi, NULL, NULL);
+                if (error == SA_OK && hpi.Timestamp == newest->timestamp)
+                        id = next;
+                else if (error == SA_OK || error == SA_ERR_HPI_NOT_PRESENT)
+                        ring_reset(log);
+                else
+                        return error;
+        }
+
+        while (id != SAHPI_NO_MORE_ENTRIES) {
+                error = saHpiEventLogEntryGet(sid, log->rid, id,
+                                              &prev, &next, &hpi, NULL, NULL);
+                if (error == SA_ERR_HPI_NOT_PRESENT)
+                        break;
+                /* The entries read so far are kept, the next sync resumes after them */
+                if (error)
+                        return error;
+
+                hpi_evlog_entry(&entry, &hpi);
+                if (ring_push(log, &entry))
+                        return SA_ERR_HPI_OUT_OF_MEMORY;
+                id = next;
+        }
+
+        log->update_timestamp = info.UpdateTimestamp;
+        log->synced = 1;
+        return SA_OK;
+}
+
+static int filter_match(const struct hpi_evlog_filter *filter,
+                        const struct hpi_evlog_entry *entry)
+{
+        return entry->severity >= filter->severity_min &&
+               entry->severity <= filter->severity_max &&
+               entry->timestamp >= filter->time_min &&
+               entry->timestamp <= filter->time_max &&
+               entry->entry_id >= filter->id_min &&
+               entry->entry_id <= filter->id_max;
+}
+
+/* Stream the entries older than the oldest kept one straight from HPI, one
+ * at a time. The walk stops at the oldest kept entry, or at the first entry
+ * logged after it if that one is gone by now. */
+static SaErrorT log_older(SaHpiSessionIdT sid,
+                          struct hpi_evlog *log,
+                          const struct hpi_evlog_filter *filter,
+                          hpi_evlog_cb cb,
+                          void *data,
+                          int *stop)
+{
+        struct hpi_evlog_entry *oldest = &log->ring[log->head];
+        struct hpi_evlog_entry entry;
+        SaHpiEventLogEntryT hpi;
+        SaHpiEventLogEntryIdT id, prev, next;
+        SaErrorT error;
+
+        for (id = SAHPI_OLDEST_ENTRY; id != SAHPI_NO_MORE_ENTRIES; id = next) {
+                error = saHpiEventLogEntryGet(sid, log->rid, id,
+                                              &prev, &next, &hpi, NULL, NULL);
+                if (error == SA_ERR_HPI_NOT_PRESENT)
+                        break;
+                if (error)
+                        return error;
+                if (hpi.EntryId == oldest->entry_id || hpi.Timestamp > oldest->timestamp)
+                        break;
+
+                hpi_evlog_entry(&entry, &hpi);
+                if (filter_match(filter, &entry) && cb(data, log->rid, &entry)) {
+                        *stop = 1;
+                        break;
+                }
+        }
+        return SA_OK;
+}
+
+/* Report the entries of one log that pass the filter, oldest first. When
+ * older entries were dropped from the ring and the filter reaches below the
+ * oldest kept entry, those are read from HPI first. */
+static SaErrorT log_entries(SaHpiSessionIdT sid,
+                            struct hpi_evlog *log,
+                            const struct hpi_evlog_filter *filter,
+                            hpi_evlog_cb cb,
+                            void *data,
+                            int *stop)
+{
+        struct hpi_evlog_entry *entry;
+        unsigned int i;
+        SaErrorT error;
+
+        if (log->truncated &&
+            filter->id_min < log->ring[log->head].entry_id &&
+            filter->time_min <= log->ring[log->head].timestamp) {
+                error = log_older(sid, log, filter, cb, data, stop);
+                if (error || *stop)
+                        return error;
+        }
+
+        for (i = 0; i < log->count; i++) {
+                entry = &log->ring[(log->head + i) % log->size];
+                if (!filter_match(filter, entry))
+                        continue;
+                if (cb(data, log->rid, entry)) {
+                        *stop = 1;
+                        break;
+                }
+        }
+        return SA_OK;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * PUBLIC INTERFACE
+ * --------------------------------------------------------------------------- */
+
+void hpi_evlog_filter_init(struct hpi_evlog_filter *filter)
+{
+        filter->one_log = 0;
+        filter->rid = SAHPI_UNSPECIFIED_RESOURCE_ID;
+        filter->severity_min = 0;
+        filter->severity_max = SAHPI_ALL_SEVERITIES;
+        filter->time_min = INT64_MIN;
+        filter->time_max = INT64_MAX;
+        filter->id_min = 0;
+        filter->id_max = SAHPI_NEWEST_ENTRY;
+}
+
+/* Copy the served part of an HPI event log entry */
+void hpi_evlog_entry(struct hpi_evlog_entry *entry, const SaHpiEventLogEntryT *hpi)
+{
+        entry->entry_id = hpi->EntryId;
+        entry->timestamp = hpi->Timestamp;
+        entry->event_timestamp = hpi->Event.Timestamp;
+        entry->source = hpi->Event.Source;
+        entry->event_type = hpi->Event.EventType;
+        entry->severity = hpi->Event.Severity;
+}
+
+/* Bring the domain log and the log of every resource with the EVENT_LOG
+ * capability up to date, then report their entries that pass 'filter'.
+ * Logs of resources no longer capable are freed once the inventory changes.
+ * A log that cannot be read is skipped, unless it is the only one the
+ * filter asks for. */
+SaErrorT hpi_evlog_foreach(struct hpi_evlog_cache *c,
+                           struct hpi_inventory *inv,
+                           SaHpiSessionIdT sid,
+                           const struct hpi_evlog_filter *filter,
+                           hpi_evlog_cb cb,
+                           void *data)
+{
+        SaHpiResourceIdT *rids, rid;
+        SaHpiUint64T generation;
+        struct hpi_evlog *log;
+        SaErrorT error, result = SA_OK;
+        int i, n, stop = 0;
+
+        /* Taken first, so a change racing the listing is swept next time */
+        generation = hpi_inventory_generation(inv);
+        n = hpi_inventory_capable(inv, SAHPI_CAPABILITY_EVENT_LOG, &rids);
+        if (n < 0)
+                return SA_ERR_HPI_OUT_OF_MEMORY;
+
+        if (filter->one_log && filter->rid != SAHPI_UNSPECIFIED_RESOURCE_ID) {
+                for (i = 0; i < n && rids[i] != filter->rid; i++)
+                        ;
+                if (i == n) {
+                        free(rids);
+                        return SA_ERR_HPI_NOT_PRESENT;
+                }
+        }
+
+        pthread_mutex_lock(&c->lock);
+        log_sweep(c, generation, rids, n);
+        for (i = -1; i < n; i++) {
+                rid = (i < 0) ? SAHPI_UNSPECIFIED_RESOURCE_ID : rids[i];
+                if (filter->one_log && rid != filter->rid)
+                        continue;
+
+                log = log_lookup(c, rid);
+                if (log == NULL) {
+                        result = SA_ERR_HPI_OUT_OF_MEMORY;
+                        break;
+                }
+                error = log_sync(sid, log);
+                if (error == SA_OK)
+                        error = log_entries(sid, log, filter, cb, data, &stop);
+                if (error && filter->one_log)
+                        result = error;
+                if (stop)
+                        break;
+        }
+        pthread_mutex_unlock(&c->lock);
+
+        free(rids);
+        return result;
+}
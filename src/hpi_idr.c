@@ -0,0 +1,433 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <SaHpi.h>
+#include <hpi_inventory.h>
+#include <hpi_idr.h>
+
+struct hpi_idr_cache hpi_idrs = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+static unsigned int idr_hash(SaHpiResourceIdT rid, SaHpiIdrIdT idrid)
+{
+        unsigned int h = rid * 0x9E3779B1U ^ idrid;
+
+        h ^= h >> 16;
+        h *= 0x85EBCA6BU;
+        h ^= h >> 13;
+        return h;
+}
+
+/* Rebuild the hash at 'size' slots. Rebuilding at the current size, after
+ * entries were dropped, allocates nothing and cannot fail. */
+static int idr_reindex(struct hpi_idr_cache *c, unsigned int size)
+{
+        unsigned int *slots, i, h;
+
+        if (size == c->slots_size) {
+                slots = c->slots;
+                memset(slots, 0, size * sizeof(*slots));
+        } else {
+                slots = calloc(size, sizeof(*slots));
+                if (slots == NULL)
+                        return -1;
+        }
+
+        for (i = 0; i < c->count; i++) {
+                h = idr_hash(c->idr[i].rid, c->idr[i].idrid) & (size - 1);
+                while (slots[h])
+                        h = (h + 1) & (size - 1);
+                slots[h] = i + 1;
+        }
+        if (slots != c->slots) {
+                free(c->slots);
+                c->slots = slots;
+                c->slots_size = size;
+        }
+        return 0;
+}
+
+static int idr_lookup(struct hpi_idr_cache *c, SaHpiResourceIdT rid, SaHpiIdrIdT idrid)
+{
+        unsigned int h, i;
+
+        if (c->slots_size == 0)
+                return -1;
+
+        for (h = idr_hash(rid, idrid) & (c->slots_size - 1); c->slots[h];
+             h = (h + 1) & (c->slots_size - 1)) {
+                i = c->slots[h] - 1;
+                if (c->idr[i].rid == rid && c->idr[i].idrid == idrid)
+                        return i;
+        }
+        return -1;
+}
+
+static int idr_append(struct hpi_idr_cache *c, SaHpiResourceIdT rid, SaHpiIdrIdT idrid)
+{
+        struct hpi_idr *idr;
+        unsigned int size, h;
+
+        if (c->count == c->size) {
+                size = c->size ? c->size * 2 : 16;
+                idr = realloc(c->idr, size * sizeof(*idr));
+                if (idr == NULL)
+                        return -1;
+                c->idr = idr;
+                c->size = size;
+        }
+        /* Keep the hash at most half full */
+        if ((c->count + 1) * 2 > c->slots_size &&
+            idr_reindex(c, c->slots_size ? c->slots_size * 2 : 32))
+                return -1;
+
+        idr = &c->idr[c->count];
+        memset(idr, 0, sizeof(*idr));
+        idr->rid = rid;
+        idr->idrid = idrid;
+
+        for (h = idr_hash(rid, idrid) & (c->slots_size - 1); c->slots[h];
+             h = (h + 1) & (c->slots_size - 1))
+                ;
+        c->slots[h] = ++c->count;
+        return c->count - 1;
+}
+
+/* Drop entry 'i', moving the last entry into its place */
+static void idr_remove(struct hpi_idr_cache *c, unsigned int i)
+{
+        free(c->idr[i].areas);
+        if (i != --c->count)
+                c->idr[i] = c->idr[c->count];
+        idr_reindex(c, c->slots_size);
+}
+
+/* Drop the IDRs whose inventory RDR went away. Removals change the
+ * inventory generation, so this only looks when the generation moved. */
+static void idr_sweep(struct hpi_idr_cache *c, struct hpi_inventory *inv)
+{
+        SaHpiUint64T generation;
+        unsigned int i, n;
+
+        generation = hpi_inventory_generation(inv);
+        if (generation == c->generation)
+                return;
+
+        for (i = 0, n = 0; i < c->count; i++) {
+                if (!hpi_inventory_present(inv, c->idr[i].rid,
+                                           SAHPI_INVENTORY_RDR, c->idr[i].idrid)) {
+                        free(c->idr[i].areas);
+                        continue;
+                }
+                if (n != i)
+                        c->idr[n] = c->idr[i];
+                n++;
+        }
+        if (n != c->count) {
+                c->count = n;
+                idr_reindex(c, c->slots_size);
+        }
+        c->generation = generation;
+}
+
+/* Drop everything known about an IDR's contents */
+static void idr_forget(struct hpi_idr *idr)
+{
+        free(idr->areas);
+        idr->areas = NULL;
+        idr->nareas = 0;
+        idr->fetched = 0;
+        idr->present = 0;
+        idr->valid = 0;
+}
+
+/* Revalidate the cached contents against the IDR UpdateCount */
+static SaErrorT idr_info(SaHpiSessionIdT sid, struct hpi_idr *idr)
+{
+        SaHpiIdrInfoT info;
+        SaErrorT error;
+
+        error = saHpiIdrInfoGet(sid, idr->rid, idr->idrid, &info);
+        if (error) {
+                idr_forget(idr);
+                return error;
+        }
+
+        if (!idr->valid || info.UpdateCount != idr->info.UpdateCount)
+                idr_forget(idr);
+        idr->info = info;
+        idr->valid = 1;
+        return SA_OK;
+}
+
+/* List the area ids once, so each field lookup is one call per area */
+static SaErrorT idr_areas(SaHpiSessionIdT sid, struct hpi_idr *idr)
+{
+        SaHpiIdrAreaHeaderT header;
+        SaHpiEntryIdT id, next;
+        SaHpiEntryIdT *areas;
+        unsigned int size;
+        SaErrorT error;
+
+        size = idr->info.NumAreas ? idr->info.NumAreas : 1;
+        idr->areas = malloc(size * sizeof(*idr->areas));
+        if (idr->areas == NULL)
+                return SA_ERR_HPI_OUT_OF_MEMORY;
+        idr->nareas = 0;
+
+        for (id = SAHPI_FIRST_ENTRY; id != SAHPI_LAST_ENTRY; id = next) {
+                error = saHpiIdrAreaHeaderGet(sid, idr->rid, idr->idrid,
+                                              SAHPI_IDR_AREATYPE_UNSPECIFIED,
+                                              id, &next, &header);
+                if (error == SA_ERR_HPI_NOT_PRESENT)
+                        break;
+                if (error) {
+                        idr_forget(idr);
+                        return error;
+                }
+                if (idr->nareas == size) {
+                        areas = realloc(idr->areas, size * 2 * sizeof(*areas));
+                        if (areas == NULL) {
+                                idr_forget(idr);
+                                return SA_ERR_HPI_OUT_OF_MEMORY;
+                        }
+                        idr->areas = areas;
+                        size *= 2;
+                }
+                idr->areas[idr->nareas++] = header.AreaId;
+        }
+        return SA_OK;
+}
+
+/* Look up the first field of one type, searching the areas in order */
+static SaErrorT idr_field(SaHpiSessionIdT sid, struct hpi_idr *idr, SaHpiIdrFieldTypeT type)
+{
+        SaHpiIdrFieldT field;
+        SaHpiEntryIdT next;
+        SaErrorT error;
+        unsigned int a;
+
+        for (a = 0; a < idr->nareas; a++) {
+                error = saHpiIdrFieldGet(sid, idr->rid, idr->idrid, idr->areas[a],
+                                         type, SAHPI_FIRST_ENTRY, &next, &field);
+                if (error == SA_ERR_HPI_NOT_PRESENT)
+                        continue;
+                if (error)
+                        return error;
+
+                memcpy(idr->field[type], field.Field.Data, field.Field.DataLength);
+                idr->field[type][field.Field.DataLength] = '\0';
+                idr->present |= HPI_IDR_FIELD(type);
+                break;
+        }
+        idr->fetched |= HPI_IDR_FIELD(type);
+        return SA_OK;
+}
+
+/* Fetch the requested field types that are not cached yet */
+static SaErrorT idr_fetch(SaHpiSessionIdT sid, struct hpi_idr *idr, unsigned int fields)
+{
+        unsigned int missing, type;
+        SaErrorT error;
+
+        missing = fields & HPI_IDR_ALL_FIELDS & ~idr->fetched;
+        if (missing == 0)
+                return SA_OK;
+
+        if (idr->areas == NULL) {
+                error = idr_areas(sid, idr);
+                if (error)
+                        return error;
+        }
+
+        for (type = 0; type < HPI_IDR_FIELDS; type++) {
+                if (!(missing & HPI_IDR_FIELD(type)))
+                        continue;
+                error = idr_field(sid, idr, type);
+                if (error)
+                        return error;
+        }
+        return SA_OK;
+}
+
+struct key_list {
+        struct hpi_idr_key *keys;
+        unsigned int count;
+        unsigned int size;
+        int failed;
+};
+
+static int collect_key(void *data, int kind, const struct hpi_inv_row *row)
+{
+        struct key_list *list = data;
+        struct hpi_idr_key *keys;
+        unsigned int size;
+
+        if (list->count == list->size) {
+                size = list->size ? list->size * 2 : 64;
+                keys = realloc(list->keys, size * sizeof(*keys));
+                if (keys == NULL) {
+                        list->failed = 1;
+                        return 1;
+                }
+                list->keys = keys;
+                list->size = size;
+        }
+        list->keys[list->count].rid = row->rid;
+        list->keys[list->count].idrid = row->num;
+        list->count++;
+        return 0;
+}
+
+static void *fill(void *arg)
+{
+        struct hpi_idr_cache *c = arg;
+        struct hpi_idr_key *keys = NULL;
+        int i, n;
+
+        n = hpi_idr_keys(&hpi_inv, &keys);
+        for (i = 0; i < n && !c->stop; i++)
+                hpi_idr_get(c, &hpi_inv, c->filler_sid, keys[i].rid, keys[i].idrid,
+                            HPI_IDR_ALL_FIELDS, NULL, NULL);
+        free(keys);
+        return NULL;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * PUBLIC INTERFACE
+ * --------------------------------------------------------------------------- */
+
+/* List the IDRs of the present inventory RDRs. The caller frees '*keys'.
+ * Returns the number of IDRs, or -1 if out of memory. */
+int hpi_idr_keys(struct hpi_inventory *inv, struct hpi_idr_key **keys)
+{
+        struct key_list list = { NULL, 0, 0, 0 };
+
+        hpi_inventory_foreach_type(inv, SAHPI_INVENTORY_RDR, collect_key, &list);
+        if (list.failed) {
+                free(list.keys);
+                *keys = NULL;
+                return -1;
+        }
+        *keys = list.keys;
+        return list.count;
+}
+
+/* Report one IDR with at least the 'fields' field types fetched. One
+ * saHpiIdrInfoGet() call checks the UpdateCount; fields already cached
+ * for this UpdateCount cost no further HPI calls. Only IDRs with a present
+ * inventory RDR in 'inv' that HPI can read are cached. The entry is taken
+ * out of the cache while HPI is read, so the cache stays unlocked and
+ * concurrent requests for the same IDR wait for it instead of fetching it
+ * twice. 'cb' may be NULL to only fill the cache. */
+SaErrorT hpi_idr_get(struct hpi_idr_cache *c,
+                     struct hpi_inventory *inv,
+                     SaHpiSessionIdT sid,
+                     SaHpiResourceIdT rid,
+                     SaHpiIdrIdT idrid,
+                     unsigned int fields,
+                     hpi_idr_cb cb,
+                     void *data)
+{
+        struct hpi_idr idr;
+        SaErrorT error;
+        int i;
+
+        pthread_mutex_lock(&c->lock);
+        for (;;) {
+                idr_sweep(c, inv);
+                i = idr_lookup(c, rid, idrid);
+                if (i < 0 || !c->idr[i].busy)
+                        break;
+                pthread_cond_wait(&c->done, &c->lock);
+        }
+        if (i < 0) {
+                if (!hpi_inventory_present(inv, rid, SAHPI_INVENTORY_RDR, idrid)) {
+                        pthread_mutex_unlock(&c->lock);
+                        return SA_ERR_HPI_NOT_PRESENT;
+                }
+                i = idr_append(c, rid, idrid);
+                if (i < 0) {
+                        pthread_mutex_unlock(&c->lock);
+                        return SA_ERR_HPI_OUT_OF_MEMORY;
+                }
+        }
+        /* The fetch owns the area list until the entry is put back */
+        idr = c->idr[i];
+        c->idr[i].areas = NULL;
+        c->idr[i].busy = 1;
+        pthread_mutex_unlock(&c->lock);
+
+        error = idr_info(sid, &idr);
+        if (error == SA_OK)
+                error = idr_fetch(sid, &idr, fields);
+
+        pthread_mutex_lock(&c->lock);
+        /* The entry may have been swept or moved meanwhile */
+        i = idr_lookup(c, rid, idrid);
+        if (i >= 0 && !idr.valid) {
+                idr_remove(c, i);
+        } else if (i >= 0) {
+                idr.busy = 0;
+                c->idr[i] = idr;
+        } else {
+                free(idr.areas);
+        }
+        pthread_cond_broadcast(&c->done);
+        pthread_mutex_unlock(&c->lock);
+
+        if (error == SA_OK && cb != NULL) {
+                idr.areas = NULL;
+                idr.nareas = 0;
+                cb(data, &idr);
+        }
+        return error;
+}
+
+/* Start filling the cache in the background from the current inventory.
+ * Returns 0 if the fill is running. */
+int hpi_idr_fill_start(struct hpi_idr_cache *c, SaHpiSessionIdT sid)
+{
+        int error = 0;
+
+        pthread_mutex_lock(&c->lock);
+        if (!c->filling) {
+                c->stop = 0;
+                c->filler_sid = sid;
+                error = pthread_create(&c->filler, NULL, fill, c);
+                c->filling = (error == 0);
+        }
+        pthread_mutex_unlock(&c->lock);
+        return error;
+}
+
+/* Stop the background fill and wait for it */
+void hpi_idr_fill_stop(struct hpi_idr_cache *c)
+{
+        int filling;
+
+        pthread_mutex_lock(&c->lock);
+        filling = c->filling;
+        c->stop = 1;
+        pthread_mutex_unlock(&c->lock);
+
+        if (filling) {
+                pthread_join(c->filler, NULL);
+                pthread_mutex_lock(&c->lock);
+                c->filling = 0;
+                pthread_mutex_unlock(&c->lock);
+        }
+}
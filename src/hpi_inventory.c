@@ -0,0 +1,1424 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <SaHpi.h>
+#include <oh_utils.h>
+#include <hpi_utils.h>
+#include <hpi_inventory.h>
+
+/* Number of removed rows remembered before clients are forced to resync */
+#define HPI_INV_MAX_TOMBSTONES  1024
+
+/* Above this many event-dirtied resources a full rescan is cheaper */
+#define HPI_INV_MAX_DIRTY       64
+
+/* Times a full scan starts over when the RPT changes under it */
+#define HPI_INV_MAX_RESTARTS    3
+
+/* Compact the string pool once this much of it is unreferenced */
+#define HPI_INV_POOL_SLACK      4096
+
+#define FNV_BASIS               2166136261U
+#define FNV_PRIME               16777619U
+
+struct hpi_inventory hpi_inv = { PTHREAD_MUTEX_INITIALIZER };
+
+static SaHpiUint32T fnv1a(SaHpiUint32T hash, const void *data, size_t len)
+{
+        const unsigned char *p = data;
+
+        while (len--) {
+                hash ^= *p++;
+                hash *= FNV_PRIME;
+        }
+        return hash;
+}
+
+static unsigned int mix(unsigned int a, unsigned int b)
+{
+        unsigned int h = a * 31 + b;
+
+        return h ^ (h >> 15);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * STRING POOL
+ * --------------------------------------------------------------------------- */
+
+/* Offset 0 always holds the empty string, which is also used on failure */
+static unsigned int pool_add(struct hpi_inv_pool *pool, const char *str, size_t len)
+{
+        unsigned int offset, size, used;
+        char *data;
+
+        if (len == 0)
+                return 0;
+
+        /* A new pool starts with the empty string already in it */
+        used = pool->data ? pool->used : 1;
+        if (used + len + 1 > pool->size) {
+                size = pool->size ? pool->size : 4096;
+                while (used + len + 1 > size)
+                        size *= 2;
+                data = realloc(pool->data, size);
+                if (data == NULL)
+                        return 0;
+                if (pool->data == NULL) {
+                        data[0] = '\0';
+                        pool->used = 1;
+                }
+                pool->data = data;
+                pool->size = size;
+        }
+
+        offset = pool->used;
+        memcpy(pool->data + offset, str, len);
+        pool->data[offset + len] = '\0';
+        pool->used += len + 1;
+        return offset;
+}
+
+static const char *pool_str(struct hpi_inv_pool *pool, unsigned int offset)
+{
+        return pool->data ? pool->data + offset : "";
+}
+
+static void pool_release(struct hpi_inv_pool *pool, unsigned int offset)
+{
+        if (offset)
+                pool->waste += strlen(pool->data + offset) + 1;
+}
+
+/* Copy the strings still referenced by resources and trie nodes into a right-sized pool */
+static void pool_compact(struct hpi_inventory *inv)
+{
+        struct hpi_inv_resources *t = &inv->res;
+        struct hpi_inv_nodes *nodes = &inv->nodes;
+        struct hpi_inv_pool pool;
+        unsigned int r, n;
+
+        memset(&pool, 0, sizeof(pool));
+        pool.size = inv->pool.used - inv->pool.waste;
+        pool.data = malloc(pool.size);
+        if (pool.data == NULL)
+                return;
+        pool.data[0] = '\0';
+        pool.used = 1;
+
+        for (r = 0; r < t->count; r++)
+                t->tag[r] = pool_add(&pool, pool_str(&inv->pool, t->tag[r]),
+                                     strlen(pool_str(&inv->pool, t->tag[r])));
+        for (n = 0; n < nodes->count; n++)
+                nodes->path[n] = pool_add(&pool, pool_str(&inv->pool, nodes->path[n]),
+                                          strlen(pool_str(&inv->pool, nodes->path[n])));
+
+        free(inv->pool.data);
+        inv->pool = pool;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * COLUMNS AND INDEXES
+ * --------------------------------------------------------------------------- */
+
+static int grow(void *column, size_t width, unsigned int size)
+{
+        void **col = column;
+        void *p;
+
+        p = realloc(*col, width * size);
+        if (p == NULL)
+                return -1;
+        *col = p;
+        return 0;
+}
+
+#define GROW(col, size) grow(&(col), sizeof(*(col)), (size))
+
+static unsigned int index_size_for(unsigned int count)
+{
+        unsigned int size = 512;
+
+        while (size < count * 2)
+                size *= 2;
+        return size;
+}
+
+static int index_alloc(struct hpi_inv_index *ix, unsigned int size)
+{
+        unsigned int *slots;
+
+        slots = calloc(size, sizeof(*slots));
+        if (slots == NULL)
+                return -1;
+        free(ix->slots);
+        ix->slots = slots;
+        ix->size = size;
+        return 0;
+}
+
+static void index_put(struct hpi_inv_index *ix, unsigned int hash, unsigned int row)
+{
+        unsigned int mask = ix->size - 1;
+        unsigned int slot = hash & mask;
+
+        while (ix->slots[slot])
+                slot = (slot + 1) & mask;
+        ix->slots[slot] = row + 1;
+}
+
+static int res_reindex(struct hpi_inv_resources *t, unsigned int size)
+{
+        unsigned int r;
+
+        if (index_alloc(&t->index, size))
+                return -1;
+        for (r = 0; r < t->count; r++)
+                index_put(&t->index, mix(t->rid[r], 0), r);
+        return 0;
+}
+
+static int rdr_reindex(struct hpi_inv_rdrs *t, unsigned int size)
+{
+        unsigned int i;
+
+        if (index_alloc(&t->index, size))
+                return -1;
+        for (i = 0; i < t->count; i++)
+                index_put(&t->index, mix(t->res[i], t->num[i]), i);
+        return 0;
+}
+
+static int res_lookup(struct hpi_inv_resources *t, SaHpiResourceIdT rid)
+{
+        unsigned int mask, slot, row;
+
+        if (t->index.size == 0)
+                return -1;
+
+        mask = t->index.size - 1;
+        slot = mix(rid, 0) & mask;
+        while ((row = t->index.slots[slot]) != 0) {
+                if (t->rid[row - 1] == rid)
+                        return row - 1;
+                slot = (slot + 1) & mask;
+        }
+        return -1;
+}
+
+static int rdr_lookup(struct hpi_inv_rdrs *t, unsigned int r, SaHpiInstrumentIdT num)
+{
+        unsigned int mask, slot, row;
+
+        if (t->index.size == 0)
+                return -1;
+
+        mask = t->index.size - 1;
+        slot = mix(r, num) & mask;
+        while ((row = t->index.slots[slot]) != 0) {
+                if (t->res[row - 1] == r && t->num[row - 1] == num)
+                        return row - 1;
+                slot = (slot + 1) & mask;
+        }
+        return -1;
+}
+
+/* Make room for one more resource row, returns the new row or -1 */
+static int res_append(struct hpi_inv_resources *t, SaHpiResourceIdT rid)
+{
+        unsigned int size, r;
+
+        if (t->count == t->size) {
+                size = t->size ? t->size * 2 : 64;
+                if (GROW(t->rid, size) || GROW(t->digest, size) ||
+                    GROW(t->info, size) || GROW(t->capabilities, size) ||
+                    GROW(t->hs_capabilities, size) || GROW(t->severity, size) ||
+                    GROW(t->failed, size) || GROW(t->removed, size) ||
+                    GROW(t->tag, size) || GROW(t->node, size) ||
+                    GROW(t->next_at_node, size) || GROW(t->first_rdr, size) ||
+                    GROW(t->scan, size))
+                        return -1;
+                t->size = size;
+        }
+        if ((t->count + 1) * 2 > t->index.size &&
+            res_reindex(t, index_size_for(t->count + 1)))
+                return -1;
+
+        r = t->count++;
+        t->rid[r] = rid;
+        t->digest[r] = 0;
+        t->removed[r] = 0;
+        t->tag[r] = 0;
+        t->node[r] = HPI_INV_NONE;
+        t->next_at_node[r] = HPI_INV_NONE;
+        t->first_rdr[r] = HPI_INV_NONE;
+        index_put(&t->index, mix(rid, 0), r);
+        return r;
+}
+
+/* Make room for one more instrument row of resource row 'r', returns the new row or -1 */
+static int rdr_append(struct hpi_inventory *inv,
+                      SaHpiRdrTypeT type,
+                      unsigned int r,
+                      SaHpiInstrumentIdT num)
+{
+        struct hpi_inv_rdrs *t = &inv->rdrs[type];
+        unsigned int size, i;
+
+        if (t->count == t->size) {
+                size = t->size ? t->size * 2 : 64;
+                if (GROW(t->res, size) || GROW(t->num, size) ||
+                    GROW(t->digest, size) || GROW(t->created, size) ||
+                    GROW(t->generation, size) || GROW(t->scan, size) ||
+                    GROW(t->removed, size) || GROW(t->next_rdr, size) ||
+                    GROW(t->asserted, size) || GROW(t->asserted_severity, size))
+                        return -1;
+                t->size = size;
+        }
+        if ((t->count + 1) * 2 > t->index.size &&
+            rdr_reindex(t, index_size_for(t->count + 1)))
+                return -1;
+
+        i = t->count++;
+        t->res[i] = r;
+        t->num[i] = num;
+        t->removed[i] = 0;
+        t->asserted[i] = 0;
+        t->next_rdr[i] = inv->res.first_rdr[r];
+        inv->res.first_rdr[r] = HPI_INV_LINK(type, i);
+        index_put(&t->index, mix(r, num), i);
+        return i;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * ENTITY PATH TRIE
+ * --------------------------------------------------------------------------- */
+
+static unsigned int node_hash(unsigned int parent, SaHpiUint32T type, SaHpiEntityLocationT location)
+{
+        return mix(mix(parent, type), location);
+}
+
+static int node_reindex(struct hpi_inv_nodes *t, unsigned int size)
+{
+        unsigned int n;
+
+        if (index_alloc(&t->index, size))
+                return -1;
+        for (n = 1; n < t->count; n++)
+                index_put(&t->index, node_hash(t->parent[n], t->type[n], t->location[n]), n);
+        return 0;
+}
+
+static unsigned int node_lookup(struct hpi_inv_nodes *t,
+                                unsigned int parent,
+                                SaHpiUint32T type,
+                                SaHpiEntityLocationT location)
+{
+        unsigned int mask, slot, row;
+
+        if (t->index.size == 0)
+                return HPI_INV_NONE;
+
+        mask = t->index.size - 1;
+        slot = node_hash(parent, type, location) & mask;
+        while ((row = t->index.slots[slot]) != 0) {
+                if (t->parent[row - 1] == parent &&
+                    t->type[row - 1] == type &&
+                    t->location[row - 1] == location)
+                        return row - 1;
+                slot = (slot + 1) & mask;
+        }
+        return HPI_INV_NONE;
+}
+
+/* Add a child node, decoding its path (the first 'depth' elements of 'ep'
+ * counted from the root) once for all resources that will share it */
+static unsigned int node_append(struct hpi_inventory *inv,
+                                unsigned int parent,
+                                const SaHpiEntityPathT *ep,
+                                int len,
+                                int depth)
+{
+        struct hpi_inv_nodes *t = &inv->nodes;
+        SaHpiEntityPathT prefix;
+        oh_big_textbuffer bigbuf;
+        unsigned int size, n;
+        int i;
+
+        if (t->count == t->size) {
+                size = t->size ? t->size * 2 : 64;
+                if (GROW(t->type, size) || GROW(t->location, size) ||
+                    GROW(t->parent, size) || GROW(t->child, size) ||
+                    GROW(t->sibling, size) || GROW(t->first_res, size) ||
+                    GROW(t->path, size) || GROW(t->health, size))
+                        return HPI_INV_NONE;
+                t->size = size;
+        }
+        if ((t->count + 1) * 2 > t->index.size &&
+            node_reindex(t, index_size_for(t->count + 1)))
+                return HPI_INV_NONE;
+
+        n = t->count++;
+        t->child[n] = HPI_INV_NONE;
+        t->first_res[n] = HPI_INV_NONE;
+        t->path[n] = 0;
+        t->health[n] = HPI_INV_NONE;
+
+        if (n == 0) {
+                /* The domain root */
+                t->type[n] = SAHPI_ENT_ROOT;
+                t->location[n] = 0;
+                t->parent[n] = HPI_INV_NONE;
+                t->sibling[n] = HPI_INV_NONE;
+                return n;
+        }
+
+        t->type[n] = ep->Entry[len - depth].EntityType;
+        t->location[n] = ep->Entry[len - depth].EntityLocation;
+        t->parent[n] = parent;
+        t->sibling[n] = t->child[parent];
+        t->child[parent] = n;
+        index_put(&t->index, node_hash(parent, t->type[n], t->location[n]), n);
+
+        memset(&prefix, 0, sizeof(prefix));
+        for (i = 0; i < depth; i++)
+                prefix.Entry[i] = ep->Entry[len - depth + i];
+        if (depth < SAHPI_MAX_ENTITY_PATH)
+                prefix.Entry[depth].EntityType = SAHPI_ENT_ROOT;
+        memset(&bigbuf, 0, sizeof(bigbuf));
+        oh_decode_entitypath(&prefix, &bigbuf);
+        t->path[n] = pool_add(&inv->pool, (char *)bigbuf.Data, bigbuf.DataLength);
+
+        return n;
+}
+
+/* Find the trie node of an entity path, optionally creating it */
+static unsigned int node_for_path(struct hpi_inventory *inv,
+                                  const SaHpiEntityPathT *ep,
+                                  int create)
+{
+        struct hpi_inv_nodes *t = &inv->nodes;
+        unsigned int n, next;
+        int len, depth;
+
+        for (len = 0; len < SAHPI_MAX_ENTITY_PATH; len++)
+                if (ep->Entry[len].EntityType == SAHPI_ENT_ROOT)
+                        break;
+
+        if (t->count == 0) {
+                if (!create || node_append(inv, HPI_INV_NONE, ep, len, 0) == HPI_INV_NONE)
+                        return HPI_INV_NONE;
+        }
+
+        /* Entry[0] is the leaf, so walk down from the last entry */
+        n = 0;
+        for (depth = 1; depth <= len; depth++) {
+                next = node_lookup(t, n,
+                                   ep->Entry[len - depth].EntityType,
+                                   ep->Entry[len - depth].EntityLocation);
+                if (next == HPI_INV_NONE) {
+                        if (!create)
+                                return HPI_INV_NONE;
+                        next = node_append(inv, n, ep, len, depth);
+                        if (next == HPI_INV_NONE)
+                                return HPI_INV_NONE;
+                }
+                n = next;
+        }
+        return n;
+}
+
+static void node_attach(struct hpi_inventory *inv, unsigned int r, unsigned int n)
+{
+        struct hpi_inv_resources *res = &inv->res;
+        unsigned int *link;
+
+        if (res->node[r] == n)
+                return;
+
+        /* Unlink from the old node */
+        if (res->node[r] != HPI_INV_NONE) {
+                link = &inv->nodes.first_res[res->node[r]];
+                while (*link != HPI_INV_NONE && *link != r)
+                        link = &res->next_at_node[*link];
+                if (*link == r)
+                        *link = res->next_at_node[r];
+        }
+
+        res->node[r] = n;
+        res->next_at_node[r] = HPI_INV_NONE;
+        if (n != HPI_INV_NONE) {
+                res->next_at_node[r] = inv->nodes.first_res[n];
+                inv->nodes.first_res[n] = r;
+        }
+}
+
+
+/* ---------------------------------------------------------------------------
+ * HEALTH ROLLUP
+ * --------------------------------------------------------------------------- */
+
+static unsigned int severity_index(SaHpiSeverityT severity)
+{
+        switch (severity) {
+                case SAHPI_CRITICAL:            return 0;
+                case SAHPI_MAJOR:               return 1;
+                case SAHPI_MINOR:               return 2;
+                case SAHPI_INFORMATIONAL:       return 3;
+                case SAHPI_OK:                  return 4;
+                default:                        return 5;
+        }
+}
+
+/* Counters of the outermost chassis containing trie node 'n', if any */
+static struct hpi_inv_health *chassis_health(struct hpi_inventory *inv,
+                                             unsigned int n,
+                                             int create)
+{
+        struct hpi_inv_nodes *t = &inv->nodes;
+        struct hpi_inv_health *health;
+        unsigned int chassis = HPI_INV_NONE;
+        unsigned int size;
+
+        for (; n != HPI_INV_NONE && n != 0; n = t->parent[n])
+                if (t->type[n] == SAHPI_ENT_SYSTEM_CHASSIS)
+                        chassis = n;
+        if (chassis == HPI_INV_NONE)
+                return NULL;
+
+        if (t->health[chassis] != HPI_INV_NONE)
+                return &inv->chassis[t->health[chassis]];
+        if (!create)
+                return NULL;
+
+        if (inv->nchassis == inv->chassis_size) {
+                size = inv->chassis_size ? inv->chassis_size * 2 : 16;
+                health = realloc(inv->chassis, size * sizeof(*health));
+                if (health == NULL)
+                        return NULL;
+                inv->chassis = health;
+                inv->chassis_size = size;
+        }
+        health = &inv->chassis[inv->nchassis];
+        memset(health, 0, sizeof(*health));
+        health->node = chassis;
+        t->health[chassis] = inv->nchassis++;
+        return health;
+}
+
+/* Add (sign 1) or remove (sign -1) a resource's part of the rollup */
+static void account_resource(struct hpi_inventory *inv, unsigned int r, int sign)
+{
+        struct hpi_inv_resources *res = &inv->res;
+        struct hpi_inv_health *health[2];
+        int k;
+
+        health[0] = &inv->domain;
+        health[1] = chassis_health(inv, res->node[r], sign > 0);
+        for (k = 0; k < 2; k++) {
+                if (health[k] == NULL)
+                        continue;
+                health[k]->resources += sign;
+                if (res->failed[r] == SAHPI_TRUE) {
+                        health[k]->failed += sign;
+                        health[k]->failed_by_severity[severity_index(res->severity[r])] += sign;
+                }
+        }
+}
+
+/* Add or remove a sensor's asserted event states from the rollup */
+static void account_sensor(struct hpi_inventory *inv, unsigned int i, int sign)
+{
+        struct hpi_inv_rdrs *t = &inv->rdrs[SAHPI_SENSOR_RDR];
+        struct hpi_inv_health *health[2];
+        int k;
+
+        if (t->asserted[i] == 0)
+                return;
+
+        health[0] = &inv->domain;
+        health[1] = chassis_health(inv, inv->res.node[t->res[i]], sign > 0);
+        for (k = 0; k < 2; k++) {
+                if (health[k] == NULL)
+                        continue;
+                health[k]->asserted += sign;
+                health[k]->asserted_by_severity[severity_index(t->asserted_severity[i])] += sign;
+        }
+}
+
+static void account_sensors_of(struct hpi_inventory *inv, unsigned int r, int sign)
+{
+        unsigned int link, i;
+
+        for (link = inv->res.first_rdr[r]; link != HPI_INV_NONE;
+             link = inv->rdrs[HPI_INV_LINK_TYPE(link)].next_rdr[i]) {
+                i = HPI_INV_LINK_ROW(link);
+                if (HPI_INV_LINK_TYPE(link) == SAHPI_SENSOR_RDR &&
+                    !inv->rdrs[SAHPI_SENSOR_RDR].removed[i])
+                        account_sensor(inv, i, sign);
+        }
+}
+
+/* Track the event states a sensor event asserts or deasserts */
+static void sensor_event(struct hpi_inventory *inv, SaHpiEventT *event)
+{
+        SaHpiSensorEventT *se = &event->EventDataUnion.SensorEvent;
+        struct hpi_inv_rdrs *t = &inv->rdrs[SAHPI_SENSOR_RDR];
+        int r, i;
+
+        r = res_lookup(&inv->res, event->Source);
+        if (r < 0 || inv->res.removed[r])
+                return;
+        i = rdr_lookup(t, r, se->SensorNum);
+        if (i < 0 || t->removed[i])
+                return;
+
+        account_sensor(inv, i, -1);
+        if (se->Assertion == SAHPI_TRUE) {
+                t->asserted[i] |= se->EventState;
+                t->asserted_severity[i] = event->Severity;
+        } else {
+                t->asserted[i] &= ~se->EventState;
+        }
+        account_sensor(inv, i, 1);
+}
+
+/* Severity of asserted states no event reported, from the threshold
+ * crossed, else the resource severity */
+static SaHpiSeverityT state_severity(const SaHpiRdrT *rdr,
+                                     SaHpiEventStateT states,
+                                     SaHpiSeverityT severity)
+{
+        if (rdr->RdrTypeUnion.SensorRec.Category != SAHPI_EC_THRESHOLD)
+                return severity;
+        if (states & (SAHPI_ES_LOWER_CRIT | SAHPI_ES_UPPER_CRIT))
+                return SAHPI_CRITICAL;
+        if (states & (SAHPI_ES_LOWER_MAJOR | SAHPI_ES_UPPER_MAJOR))
+                return SAHPI_MAJOR;
+        if (states & (SAHPI_ES_LOWER_MINOR | SAHPI_ES_UPPER_MINOR))
+                return SAHPI_MINOR;
+        return severity;
+}
+
+/* Set a sensor's asserted event states from its current state, so states
+ * asserted before the subscription or by lost events are counted. As with
+ * sensor_event(), only states that raise assert events count. */
+static void seed_sensor(struct hpi_inventory *inv,
+                        SaHpiSessionIdT sid,
+                        unsigned int r,
+                        const SaHpiRdrT *rdr)
+{
+        struct hpi_inv_rdrs *t = &inv->rdrs[SAHPI_SENSOR_RDR];
+        SaHpiSensorNumT num = rdr->RdrTypeUnion.SensorRec.Num;
+        SaHpiEventStateT state, mask;
+        int i;
+
+        i = rdr_lookup(t, r, num);
+        if (i < 0 || t->removed[i])
+                return;
+
+        if (saHpiSensorReadingGet(sid, inv->res.rid[r], num, NULL, &state) != SA_OK ||
+            saHpiSensorEventMasksGet(sid, inv->res.rid[r], num, &mask, NULL) != SA_OK)
+                return;
+        state &= mask;
+        if (state == t->asserted[i])
+                return;
+
+        account_sensor(inv, i, -1);
+        if (state & ~t->asserted[i])
+                t->asserted_severity[i] = state_severity(rdr, state, inv->res.severity[r]);
+        t->asserted[i] = state;
+        account_sensor(inv, i, 1);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * SCANNING
+ * --------------------------------------------------------------------------- */
+
+/* Record the current state of one resource, returns its row or -1 */
+static int merge_resource(struct hpi_inventory *inv,
+                          SaHpiRptEntryT *entry,
+                          int *changed)
+{
+        struct hpi_inv_resources *t = &inv->res;
+        SaHpiUint32T digest;
+        unsigned int node;
+        int r, counted = 0;
+
+        digest = fnv1a(FNV_BASIS, entry, sizeof(*entry));
+
+        *changed = 0;
+        r = res_lookup(t, entry->ResourceId);
+        if (r < 0) {
+                r = res_append(t, entry->ResourceId);
+                if (r < 0)
+                        return -1;
+                *changed = 1;
+        } else if (t->removed[r]) {
+                t->removed[r] = 0;
+                inv->tombstones--;
+                *changed = 1;
+        } else if (t->digest[r] != digest) {
+                *changed = 1;
+                counted = 1;
+        }
+        t->scan[r] = inv->scan;
+        if (!*changed)
+                return r;
+
+        if (counted)
+                account_resource(inv, r, -1);
+
+        t->digest[r] = digest;
+        t->info[r] = entry->ResourceInfo;
+        t->capabilities[r] = entry->ResourceCapabilities;
+        t->hs_capabilities[r] = entry->HotSwapCapabilities;
+        t->severity[r] = entry->ResourceSeverity;
+        t->failed[r] = entry->ResourceFailed;
+
+        pool_release(&inv->pool, t->tag[r]);
+        t->tag[r] = pool_add(&inv->pool, (char *)entry->ResourceTag.Data,
+                             strnlen((char *)entry->ResourceTag.Data,
+                                     sizeof(entry->ResourceTag.Data)));
+
+        node = node_for_path(inv, &entry->ResourceEntity, 1);
+        if (node != t->node[r]) {
+                /* Sensor assertions follow the resource to its new chassis */
+                if (counted)
+                        account_sensors_of(inv, r, -1);
+                node_attach(inv, r, node);
+                if (counted)
+                        account_sensors_of(inv, r, 1);
+        }
+
+        account_resource(inv, r, 1);
+        return r;
+}
+
+/* Record the current state of one RDR, returns 1 if it changed. 'fresh'
+ * is set if the row is new, came back, or its own RDR changed. */
+static int merge_rdr(struct hpi_inventory *inv,
+                     unsigned int r,
+                     SaHpiRdrT *rdr,
+                     SaHpiInstrumentIdT num,
+                     int force,
+                     SaHpiUint64T gen,
+                     int *fresh)
+{
+        struct hpi_inv_rdrs *t;
+        SaHpiUint32T digest;
+        int i;
+
+        *fresh = 0;
+        if ((unsigned int)rdr->RdrType >= HPI_INV_RDR_TYPES)
+                return 0;
+
+        t = &inv->rdrs[rdr->RdrType];
+        digest = fnv1a(FNV_BASIS, rdr, sizeof(*rdr));
+
+        i = rdr_lookup(t, r, num);
+        if (i < 0) {
+                i = rdr_append(inv, rdr->RdrType, r, num);
+                if (i < 0)
+                        return 0;
+                t->digest[i] = digest;
+                t->created[i] = gen;
+                t->generation[i] = gen;
+                t->scan[i] = inv->scan;
+                *fresh = 1;
+                return 1;
+        }
+
+        t->scan[i] = inv->scan;
+        if (t->removed[i]) {
+                t->removed[i] = 0;
+                inv->tombstones--;
+                t->digest[i] = digest;
+                t->created[i] = gen;
+                t->generation[i] = gen;
+                *fresh = 1;
+                return 1;
+        }
+        if (t->digest[i] != digest)
+                *fresh = 1;
+        if (force || *fresh) {
+                t->digest[i] = digest;
+                t->generation[i] = gen;
+                return 1;
+        }
+        return 0;
+}
+
+/* Walk one resource and its RDRs, returns the number of instrument rows that changed */
+static int scan_resource(struct hpi_inventory *inv,
+                         SaHpiSessionIdT sid,
+                         SaHpiRptEntryT *entry,
+                         SaHpiUint64T gen)
+{
+        SaErrorT error;
+        SaHpiEntryIdT rdr_id;
+        SaHpiRdrT rdr;
+        int r, num, res_changed, fresh, changed = 0;
+
+        r = merge_resource(inv, entry, &res_changed);
+        if (r < 0)
+                return 0;
+
+        /* A resource change moves the generation even without rows, so the
+           caches keyed by resource see it */
+        changed = res_changed;
+        if (!(entry->ResourceCapabilities & SAHPI_CAPABILITY_RDR))
+                return changed;
+
+        /* Every instance carries its resource's properties, so a resource
+           change touches all of its instrument rows */
+        rdr_id = SAHPI_FIRST_ENTRY;
+        do {
+                memset(&rdr, 0, sizeof(rdr));
+                error = saHpiRdrGet(sid, entry->ResourceId, rdr_id, &rdr_id, &rdr);
+                if (error != SA_OK)
+                        break;
+
+                num = management_instrument_id(&rdr);
+                if (num == -1)
+                        continue;
+
+                changed += merge_rdr(inv, r, &rdr, (SaHpiInstrumentIdT)num,
+                                     res_changed, gen, &fresh);
+                /* Known sensors are kept current by their events */
+                if (rdr.RdrType == SAHPI_SENSOR_RDR && (fresh || inv->reseed))
+                        seed_sensor(inv, sid, r, &rdr);
+        } while (rdr_id != SAHPI_LAST_ENTRY);
+
+        return changed;
+}
+
+static int rid_compare(const void *a, const void *b)
+{
+        SaHpiResourceIdT x = *(const SaHpiResourceIdT *)a;
+        SaHpiResourceIdT y = *(const SaHpiResourceIdT *)b;
+
+        return (x > y) - (x < y);
+}
+
+static int is_dirty(struct hpi_inventory *inv, SaHpiResourceIdT rid)
+{
+        return bsearch(&rid, inv->dirty, inv->ndirty,
+                       sizeof(inv->dirty[0]), rid_compare) != NULL;
+}
+
+static void mark_dirty(struct hpi_inventory *inv, SaHpiResourceIdT rid)
+{
+        SaHpiResourceIdT *dirty;
+        unsigned int i, size;
+
+        for (i = 0; i < inv->ndirty; i++)
+                if (inv->dirty[i] == rid)
+                        return;
+
+        if (inv->ndirty == inv->dirty_size) {
+                size = inv->dirty_size ? inv->dirty_size * 2 : 16;
+                dirty = realloc(inv->dirty, size * sizeof(*dirty));
+                if (dirty == NULL) {
+                        /* Lose track of the resource and fall back to a full scan */
+                        inv->scanned = 0;
+                        return;
+                }
+                inv->dirty = dirty;
+                inv->dirty_size = size;
+        }
+        inv->dirty[inv->ndirty++] = rid;
+}
+
+/* Drain pending HPI events and note which resources they touched. If the
+ * queue overflowed, events were lost: the next scan is a full one and
+ * reads the state of every sensor again. */
+static void drain_events(struct hpi_inventory *inv, SaHpiSessionIdT sid)
+{
+        SaHpiEventT event;
+        SaHpiEvtQueueStatusT status;
+
+        while (saHpiEventGet(sid, SAHPI_TIMEOUT_IMMEDIATE,
+                             &event, NULL, NULL, &status) == SA_OK) {
+                if (status & SAHPI_EVT_QUEUE_OVERFLOW) {
+                        inv->scanned = 0;
+                        inv->reseed = 1;
+                }
+                switch (event.EventType) {
+                        case SAHPI_ET_RESOURCE:
+                        case SAHPI_ET_HOTSWAP:
+                                mark_dirty(inv, event.Source);
+                                break;
+                        case SAHPI_ET_SENSOR:
+                                sensor_event(inv, &event);
+                                break;
+                        default:
+                                break;
+                }
+        }
+}
+
+/* Mark everything in scope that this scan did not see as removed */
+static int sweep(struct hpi_inventory *inv, int full, SaHpiUint64T gen)
+{
+        struct hpi_inv_resources *res = &inv->res;
+        struct hpi_inv_rdrs *t;
+        unsigned int r, i, type;
+        int changed = 0;
+
+        for (r = 0; r < res->count; r++) {
+                if (res->removed[r] || res->scan[r] == inv->scan)
+                        continue;
+                if (!full && !is_dirty(inv, res->rid[r]))
+                        continue;
+                account_resource(inv, r, -1);
+                res->removed[r] = 1;
+                inv->tombstones++;
+                changed++;
+        }
+
+        for (type = 0; type < HPI_INV_RDR_TYPES; type++) {
+                t = &inv->rdrs[type];
+                for (i = 0; i < t->count; i++) {
+                        if (t->removed[i] || t->scan[i] == inv->scan)
+                                continue;
+                        if (!full && !is_dirty(inv, res->rid[t->res[i]]))
+                                continue;
+                        if (type == SAHPI_SENSOR_RDR) {
+                                account_sensor(inv, i, -1);
+                                t->asserted[i] = 0;
+                        }
+                        t->removed[i] = 1;
+                        t->generation[i] = gen;
+                        inv->tombstones++;
+                        changed++;
+                }
+        }
+        return changed;
+}
+
+/* Drop all removed rows; older tokens can no longer see those removals */
+static void prune(struct hpi_inventory *inv)
+{
+        struct hpi_inv_resources *res = &inv->res;
+        struct hpi_inv_rdrs *t;
+        struct hpi_inv_index res_index, rdr_index[HPI_INV_RDR_TYPES];
+        unsigned int *remap;
+        unsigned int r, n, i, j, type;
+        int ok;
+
+        /* Allocate the new indexes before any row moves. If one cannot be
+           had, the tombstones stay until the next prune. */
+        memset(&res_index, 0, sizeof(res_index));
+        memset(rdr_index, 0, sizeof(rdr_index));
+        for (r = 0, n = 0; r < res->count; r++)
+                n += !res->removed[r];
+        remap = malloc((res->count ? res->count : 1) * sizeof(*remap));
+        ok = remap != NULL && index_alloc(&res_index, index_size_for(n)) == 0;
+        for (type = 0; ok && type < HPI_INV_RDR_TYPES; type++) {
+                t = &inv->rdrs[type];
+                for (i = 0, j = 0; i < t->count; i++)
+                        j += !t->removed[i];
+                ok = index_alloc(&rdr_index[type], index_size_for(j)) == 0;
+        }
+        if (!ok) {
+                free(remap);
+                free(res_index.slots);
+                for (type = 0; type < HPI_INV_RDR_TYPES; type++)
+                        free(rdr_index[type].slots);
+                return;
+        }
+
+        /* A present instrument row always belongs to a present resource */
+        for (r = 0, n = 0; r < res->count; r++) {
+                if (res->removed[r]) {
+                        pool_release(&inv->pool, res->tag[r]);
+                        continue;
+                }
+                res->rid[n] = res->rid[r];
+                res->digest[n] = res->digest[r];
+                res->info[n] = res->info[r];
+                res->capabilities[n] = res->capabilities[r];
+                res->hs_capabilities[n] = res->hs_capabilities[r];
+                res->severity[n] = res->severity[r];
+                res->failed[n] = res->failed[r];
+                res->removed[n] = 0;
+                res->tag[n] = res->tag[r];
+                res->node[n] = res->node[r];
+                res->first_rdr[n] = HPI_INV_NONE;
+                res->scan[n] = res->scan[r];
+                index_put(&res_index, mix(res->rid[n], 0), n);
+                remap[r] = n++;
+        }
+        res->count = n;
+        free(res->index.slots);
+        res->index = res_index;
+
+        /* Row numbers changed, so rebuild the per-node resource lists */
+        for (i = 0; i < inv->nodes.count; i++)
+                inv->nodes.first_res[i] = HPI_INV_NONE;
+        for (r = 0; r < res->count; r++) {
+                res->next_at_node[r] = HPI_INV_NONE;
+                if (res->node[r] == HPI_INV_NONE)
+                        continue;
+                res->next_at_node[r] = inv->nodes.first_res[res->node[r]];
+                inv->nodes.first_res[res->node[r]] = r;
+        }
+
+        for (type = 0; type < HPI_INV_RDR_TYPES; type++) {
+                t = &inv->rdrs[type];
+                for (i = 0, j = 0; i < t->count; i++) {
+                        if (t->removed[i])
+                                continue;
+                        t->res[j] = remap[t->res[i]];
+                        t->num[j] = t->num[i];
+                        t->digest[j] = t->digest[i];
+                        t->created[j] = t->created[i];
+                        t->generation[j] = t->generation[i];
+                        t->scan[j] = t->scan[i];
+                        t->removed[j] = 0;
+                        t->asserted[j] = t->asserted[i];
+                        t->asserted_severity[j] = t->asserted_severity[i];
+                        t->next_rdr[j] = res->first_rdr[t->res[j]];
+                        res->first_rdr[t->res[j]] = HPI_INV_LINK(type, j);
+                        index_put(&rdr_index[type], mix(t->res[j], t->num[j]), j);
+                        j++;
+                }
+                t->count = j;
+                free(t->index.slots);
+                t->index = rdr_index[type];
+        }
+
+        free(remap);
+        inv->tombstones = 0;
+        inv->horizon = inv->generation;
+}
+
+static SaErrorT refresh(struct hpi_inventory *inv, SaHpiSessionIdT sid)
+{
+        SaErrorT error;
+        SaHpiDomainInfoT domain_info;
+        SaHpiRptEntryT entry;
+        SaHpiEntryIdT entry_id, next_id;
+        SaHpiUint64T gen;
+        unsigned int i;
+        int full, restarts, changed = 0;
+
+        error = saHpiDomainInfoGet(sid, &domain_info);
+        if (error != SA_OK)
+                return error;
+
+        inv->domain.active_alarms = domain_info.ActiveAlarms;
+        inv->domain.critical_alarms = domain_info.CriticalAlarms;
+        inv->domain.major_alarms = domain_info.MajorAlarms;
+        inv->domain.minor_alarms = domain_info.MinorAlarms;
+
+        drain_events(inv, sid);
+
+        full = !inv->scanned ||
+               inv->did != domain_info.DomainId ||
+               inv->rpt_update_count != domain_info.RptUpdateCount ||
+               inv->ndirty > HPI_INV_MAX_DIRTY;
+        if (!full && inv->ndirty == 0)
+                return SA_OK;
+
+        if (inv->generation == 0) {
+                /* Seed from the clock so tokens stay monotonic across provider restarts */
+                inv->generation = (SaHpiUint64T)time(NULL) << 24;
+                inv->horizon = inv->generation;
+        }
+        gen = inv->generation + 1;
+        inv->did = domain_info.DomainId;
+        inv->scan++;
+
+        if (full) {
+                restarts = 0;
+                next_id = SAHPI_FIRST_ENTRY;
+                do {
+                        entry_id = next_id;
+                        memset(&entry, 0, sizeof(entry));
+                        error = saHpiRptEntryGet(sid, entry_id, &next_id, &entry);
+                        if (error == SA_ERR_HPI_NOT_PRESENT && entry_id != SAHPI_FIRST_ENTRY &&
+                            restarts++ < HPI_INV_MAX_RESTARTS) {
+                                /* The next entry went away under a hot swap. Rows
+                                   already seen match their digests on the second
+                                   pass, so walking again only costs the calls. */
+                                next_id = SAHPI_FIRST_ENTRY;
+                                continue;
+                        }
+                        if (error != SA_OK) {
+                                /* Never leave rows stamped with an unpublished generation */
+                                if (changed)
+                                        inv->generation = gen;
+                                return error;
+                        }
+
+                        changed += scan_resource(inv, sid, &entry, gen);
+                } while (next_id != SAHPI_LAST_ENTRY);
+        } else {
+                for (i = 0; i < inv->ndirty; i++) {
+                        memset(&entry, 0, sizeof(entry));
+                        error = saHpiRptEntryGetByResourceId(sid, inv->dirty[i], &entry);
+                        if (error == SA_OK)
+                                changed += scan_resource(inv, sid, &entry, gen);
+                }
+                qsort(inv->dirty, inv->ndirty, sizeof(inv->dirty[0]), rid_compare);
+        }
+
+        changed += sweep(inv, full, gen);
+
+        inv->rpt_update_count = domain_info.RptUpdateCount;
+        inv->scanned = 1;
+        if (full)
+                inv->reseed = 0;
+        inv->ndirty = 0;
+
+        if (changed)
+                inv->generation = gen;
+        if (inv->tombstones > HPI_INV_MAX_TOMBSTONES)
+                prune(inv);
+        if (inv->pool.waste > HPI_INV_POOL_SLACK &&
+            inv->pool.waste > inv->pool.used / 2)
+                pool_compact(inv);
+
+        return SA_OK;
+}
+
+static void row_view(struct hpi_inventory *inv,
+                     SaHpiRdrTypeT type,
+                     unsigned int i,
+                     struct hpi_inv_row *row)
+{
+        struct hpi_inv_rdrs *t = &inv->rdrs[type];
+        struct hpi_inv_resources *res = &inv->res;
+        unsigned int r = t->res[i];
+
+        row->did = inv->did;
+        row->rid = res->rid[r];
+        row->rdr_type = type;
+        row->num = t->num[i];
+        row->generation = t->generation[i];
+        row->info = &res->info[r];
+        row->capabilities = res->capabilities[r];
+        row->hs_capabilities = res->hs_capabilities[r];
+        row->severity = res->severity[r];
+        row->failed = res->failed[r];
+        row->tag = pool_str(&inv->pool, res->tag[r]);
+        row->entity_path = res->node[r] == HPI_INV_NONE ? "" :
+                           pool_str(&inv->pool, inv->nodes.path[res->node[r]]);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * PUBLIC INTERFACE
+ * --------------------------------------------------------------------------- */
+
+/* Bring the inventory up to date with the HPI domain */
+SaErrorT hpi_inventory_refresh(struct hpi_inventory *inv, SaHpiSessionIdT sid)
+{
+        SaErrorT error;
+
+        pthread_mutex_lock(&inv->lock);
+        error = refresh(inv, sid);
+        pthread_mutex_unlock(&inv->lock);
+        return error;
+}
+
+static int type_rows(struct hpi_inventory *inv,
+                     SaHpiRdrTypeT type,
+                     hpi_inv_row_cb cb,
+                     void *data)
+{
+        struct hpi_inv_rdrs *t = &inv->rdrs[type];
+        struct hpi_inv_row row;
+        unsigned int i;
+
+        for (i = 0; i < t->count; i++) {
+                if (t->removed[i])
+                        continue;
+                row_view(inv, type, i, &row);
+                if (cb(data, HPI_INV_PRESENT, &row))
+                        return 1;
+        }
+        return 0;
+}
+
+/* Report every present instrument row, grouped by RDR type */
+void hpi_inventory_foreach(struct hpi_inventory *inv,
+                           hpi_inv_row_cb cb,
+                           void *data)
+{
+        unsigned int type;
+
+        pthread_mutex_lock(&inv->lock);
+        for (type = 0; type < HPI_INV_RDR_TYPES; type++)
+                if (type_rows(inv, type, cb, data))
+                        break;
+        pthread_mutex_unlock(&inv->lock);
+}
+
+/* Report the present instrument rows of one RDR type only */
+void hpi_inventory_foreach_type(struct hpi_inventory *inv,
+                                SaHpiRdrTypeT type,
+                                hpi_inv_row_cb cb,
+                                void *data)
+{
+        if ((unsigned int)type >= HPI_INV_RDR_TYPES)
+                return;
+
+        pthread_mutex_lock(&inv->lock);
+        type_rows(inv, type, cb, data);
+        pthread_mutex_unlock(&inv->lock);
+}
+
+/* Returns 1 if the instrument row of RDR 'type' and 'num' of resource
+ * 'rid' is present, 0 otherwise */
+int hpi_inventory_present(struct hpi_inventory *inv,
+                          SaHpiResourceIdT rid,
+                          SaHpiRdrTypeT type,
+                          SaHpiInstrumentIdT num)
+{
+        int r, i, present = 0;
+
+        if ((unsigned int)type >= HPI_INV_RDR_TYPES)
+                return 0;
+
+        pthread_mutex_lock(&inv->lock);
+        r = res_lookup(&inv->res, rid);
+        if (r >= 0 && !inv->res.removed[r]) {
+                i = rdr_lookup(&inv->rdrs[type], r, num);
+                present = (i >= 0 && !inv->rdrs[type].removed[i]);
+        }
+        pthread_mutex_unlock(&inv->lock);
+        return present;
+}
+
+/* Domain the inventory was last read from, 0 before the first refresh */
+SaHpiDomainIdT hpi_inventory_domain(struct hpi_inventory *inv)
+{
+        SaHpiDomainIdT did;
+
+        pthread_mutex_lock(&inv->lock);
+        did = inv->did;
+        pthread_mutex_unlock(&inv->lock);
+        return did;
+}
+
+/* Current generation token */
+SaHpiUint64T hpi_inventory_generation(struct hpi_inventory *inv)
+{
+        SaHpiUint64T generation;
+
+        pthread_mutex_lock(&inv->lock);
+        generation = inv->generation;
+        pthread_mutex_unlock(&inv->lock);
+        return generation;
+}
+
+/* List the present resources with all of the 'capabilities' bits set. The
+ * caller frees '*rids'. Returns the number of resources, or -1 if out of
+ * memory. */
+int hpi_inventory_capable(struct hpi_inventory *inv,
+                          SaHpiCapabilitiesT capabilities,
+                          SaHpiResourceIdT **rids)
+{
+        struct hpi_inv_resources *res = &inv->res;
+        unsigned int r;
+        int n = 0;
+
+        pthread_mutex_lock(&inv->lock);
+        *rids = malloc((res->count ? res->count : 1) * sizeof(**rids));
+        if (*rids == NULL) {
+                pthread_mutex_unlock(&inv->lock);
+                return -1;
+        }
+        for (r = 0; r < res->count; r++)
+                if (!res->removed[r] &&
+                    (res->capabilities[r] & capabilities) == capabilities)
+                        (*rids)[n++] = res->rid[r];
+        pthread_mutex_unlock(&inv->lock);
+        return n;
+}
+
+/* Report the present instrument rows of the resources at one trie node */
+static int node_rows(struct hpi_inventory *inv,
+                     unsigned int n,
+                     hpi_inv_row_cb cb,
+                     void *data)
+{
+        struct hpi_inv_resources *res = &inv->res;
+        struct hpi_inv_row row;
+        unsigned int r, link, type, i;
+
+        for (r = inv->nodes.first_res[n]; r != HPI_INV_NONE; r = res->next_at_node[r]) {
+                if (res->removed[r])
+                        continue;
+                for (link = res->first_rdr[r]; link != HPI_INV_NONE;
+                     link = inv->rdrs[type].next_rdr[i]) {
+                        type = HPI_INV_LINK_TYPE(link);
+                        i = HPI_INV_LINK_ROW(link);
+                        if (inv->rdrs[type].removed[i])
+                                continue;
+                        row_view(inv, type, i, &row);
+                        if (cb(data, HPI_INV_PRESENT, &row))
+                                return 1;
+                }
+        }
+        return 0;
+}
+
+/* Report the present instrument rows of resources at entity path 'ep', and
+ * if 'descend' is set of every resource below it too. The walk only visits
+ * the matching part of the trie. Returns -1 if no resource was ever seen
+ * at or below 'ep'. */
+int hpi_inventory_subtree(struct hpi_inventory *inv,
+                          const SaHpiEntityPathT *ep,
+                          int descend,
+                          hpi_inv_row_cb cb,
+                          void *data)
+{
+        struct hpi_inv_nodes *t = &inv->nodes;
+        unsigned int top, n;
+
+        pthread_mutex_lock(&inv->lock);
+
+        top = node_for_path(inv, ep, 0);
+        if (top == HPI_INV_NONE) {
+                pthread_mutex_unlock(&inv->lock);
+                return -1;
+        }
+
+        if (!descend) {
+                node_rows(inv, top, cb, data);
+                pthread_mutex_unlock(&inv->lock);
+                return 0;
+        }
+
+        /* Preorder walk over the subtree without a stack, via parent links */
+        n = top;
+        while (n != HPI_INV_NONE) {
+                if (node_rows(inv, n, cb, data))
+                        break;
+                if (t->child[n] != HPI_INV_NONE) {
+                        n = t->child[n];
+                        continue;
+                }
+                while (n != top && t->sibling[n] == HPI_INV_NONE)
+                        n = t->parent[n];
+                n = (n == top) ? HPI_INV_NONE : t->sibling[n];
+        }
+
+        pthread_mutex_unlock(&inv->lock);
+        return 0;
+}
+
+/* Report the health rollup of the domain followed by that of each chassis */
+void hpi_inventory_health(struct hpi_inventory *inv,
+                          hpi_inv_health_cb cb,
+                          void *data)
+{
+        unsigned int i;
+
+        pthread_mutex_lock(&inv->lock);
+        if (cb(data, inv->did, NULL, &inv->domain) == 0) {
+                for (i = 0; i < inv->nchassis; i++) {
+                        if (cb(data, inv->did,
+                               pool_str(&inv->pool, inv->nodes.path[inv->chassis[i].node]),
+                               &inv->chassis[i]))
+                                break;
+                }
+        }
+        pthread_mutex_unlock(&inv->lock);
+}
+
+/* Report the health rollup of one chassis, or of the domain if 'chassis' is
+ * NULL. Returns -1 if the chassis has no counters. */
+int hpi_inventory_health_get(struct hpi_inventory *inv,
+                             const SaHpiEntityPathT *chassis,
+                             hpi_inv_health_cb cb,
+                             void *data)
+{
+        unsigned int n;
+
+        pthread_mutex_lock(&inv->lock);
+        if (chassis == NULL) {
+                cb(data, inv->did, NULL, &inv->domain);
+                pthread_mutex_unlock(&inv->lock);
+                return 0;
+        }
+
+        n = node_for_path(inv, chassis, 0);
+        if (n == HPI_INV_NONE || inv->nodes.health[n] == HPI_INV_NONE) {
+                pthread_mutex_unlock(&inv->lock);
+                return -1;
+        }
+        cb(data, inv->did, pool_str(&inv->pool, inv->nodes.path[n]),
+           &inv->chassis[inv->nodes.health[n]]);
+        pthread_mutex_unlock(&inv->lock);
+        return 0;
+}
+
+/* Report every row added, modified or removed after generation 'since'.
+ * Returns 1 if 'since' is too old (or unknown) for a precise delta, in which
+ * case all present rows are reported as added. */
+int hpi_inventory_changes(struct hpi_inventory *inv,
+                          SaHpiUint64T since,
+                          SaHpiUint64T *generation,
+                          hpi_inv_row_cb cb,
+                          void *data)
+{
+        struct hpi_inv_rdrs *t;
+        struct hpi_inv_row row;
+        unsigned int i, type;
+        int kind, resync;
+
+        pthread_mutex_lock(&inv->lock);
+
+        resync = since < inv->horizon || since > inv->generation;
+        for (type = 0; type < HPI_INV_RDR_TYPES; type++) {
+                t = &inv->rdrs[type];
+                for (i = 0; i < t->count; i++) {
+                        if (resync) {
+                                if (t->removed[i])
+                                        continue;
+                                kind = HPI_INV_ADDED;
+                        } else if (t->generation[i] <= since) {
+                                continue;
+                        } else if (t->created[i] > since) {
+                                if (t->removed[i])
+                                        continue;
+                                kind = HPI_INV_ADDED;
+                        } else if (t->removed[i]) {
+                                kind = HPI_INV_REMOVED;
+                        } else {
+                                kind = HPI_INV_MODIFIED;
+                        }
+                        row_view(inv, type, i, &row);
+                        if (cb(data, kind, &row))
+                                goto done;
+                }
+        }
+done:
+        *generation = inv->generation;
+
+        pthread_mutex_unlock(&inv->lock);
+        return resync;
+}
@@ -0,0 +1,170 @@
+/*      -*- linux-c -*-
+ *
+ * (C) Copyright IBM Corp. 2005
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  This
+ * file and program are licensed under a BSD style license.  See
+ * the Copying file included with the OpenHPI distribution for
+ * full licensing terms.
+ *
+ */
+
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <hpi_query.h>
+
+/* Copy the next identifier into 'buf', returns the position after it */
+static const char *word(const char *p, char *buf, size_t len)
+{
+        size_t n = 0;
+
+        while (isspace((unsigned char)*p))
+                p++;
+        while (isalnum((unsigned char)*p) || *p == '_' || *p == '*') {
+                if (n + 1 < len)
+                        buf[n++] = *p;
+                p++;
+        }
+        buf[n] = '\0';
+        return p;
+}
+
+/* Match a keyword, returns the position after it or NULL */
+static const char *keyword(const char *p, const char *kw)
+{
+        char buf[16];
+        const char *next;
+
+        next = word(p, buf, sizeof(buf));
+        return strcasecmp(buf, kw) == 0 ? next : NULL;
+}
+
+static const char *operator(const char *p, int *op)
+{
+        const char *next;
+
+        while (isspace((unsigned char)*p))
+                p++;
+
+        if ((next = keyword(p, "LIKE")) != NULL) {
+                *op = HPI_QUERY_LIKE;
+                return next;
+        }
+        if (strncmp(p, "<>", 2) == 0 || strncmp(p, "!=", 2) == 0) {
+                *op = HPI_QUERY_NE;
+                return p + 2;
+        }
+        if (strncmp(p, "<=", 2) == 0) {
+                *op = HPI_QUERY_LE;
+                return p + 2;
+        }
+        if (strncmp(p, ">=", 2) == 0) {
+                *op = HPI_QUERY_GE;
+                return p + 2;
+        }
+        switch (*p) {
+                case '=': *op = HPI_QUERY_EQ; return p + 1;
+                case '<': *op = HPI_QUERY_LT; return p + 1;
+                case '>': *op = HPI_QUERY_GT; return p + 1;
+        }
+        return NULL;
+}
+
+/* A quoted string ('' escapes a quote) or a bare number */
+static const char *literal(const char *p, struct hpi_query_cond *cond)
+{
+        size_t n = 0;
+        char quote;
+
+        while (isspace((unsigned char)*p))
+                p++;
+
+        if (*p == '\'' || *p == '"') {
+                quote = *p++;
+                cond->is_string = 1;
+                for (;;) {
+                        if (*p == '\0')
+                                return NULL;
+                        if (*p == quote) {
+                                if (p[1] != quote)
+                                        break;
+                                p++;
+                        }
+                        if (n + 1 >= sizeof(cond->value))
+                                return NULL;
+                        cond->value[n++] = *p++;
+                }
+                cond->value[n] = '\0';
+                return p + 1;
+        }
+
+        cond->is_string = 0;
+        while (isalnum((unsigned char)*p) || *p == '-' || *p == '+' || *p == '.') {
+                if (n + 1 >= sizeof(cond->value))
+                        return NULL;
+                cond->value[n++] = *p++;
+        }
+        cond->value[n] = '\0';
+        return n ? p : NULL;
+}
+
+/* Parse the small subset of WQL/CQL that the HPI providers can serve
+ * directly: a SELECT * over one class with ANDed property comparisons.
+ * Returns 0 on success, -1 for anything else. */
+int hpi_query_parse(const char *language, const char *query, struct hpi_query *q)
+{
+        struct hpi_query_cond *cond;
+        const char *p, *next;
+        char buf[16];
+
+        if (language == NULL || query == NULL ||
+            (strcasecmp(language, "WQL") != 0 && strncasecmp(language, "CQL", 3) != 0))
+                return -1;
+
+        memset(q, 0, sizeof(*q));
+
+        if ((p = keyword(query, "SELECT")) == NULL)
+                return -1;
+        p = word(p, buf, sizeof(buf));
+        if (strcmp(buf, "*") != 0)
+                return -1;
+        if ((p = keyword(p, "FROM")) == NULL)
+                return -1;
+        p = word(p, q->classname, sizeof(q->classname));
+        if (q->classname[0] == '\0')
+                return -1;
+
+        if ((next = keyword(p, "WHERE")) != NULL) {
+                p = next;
+                do {
+                        if (q->ncond == HPI_QUERY_MAX_CONDS)
+                                return -1;
+                        cond = &q->cond[q->ncond++];
+                        p = word(p, cond->property, sizeof(cond->property));
+                        if (cond->property[0] == '\0')
+                                return -1;
+                        if ((p = operator(p, &cond->op)) == NULL)
+                                return -1;
+                        if ((p = literal(p, cond)) == NULL)
+                                return -1;
+                } while ((next = keyword(p, "AND")) != NULL && (p = next));
+        }
+
+        while (isspace((unsigned char)*p) || *p == ';')
+                p++;
+        return *p == '\0' ? 0 : -1;
+}
+
+/* Find the condition on a property, if any */
+struct hpi_query_cond *hpi_query_find(struct hpi_query *q, const char *property)
+{
+        int i;
+
+        for (i = 0; i < q->ncond; i++)
+                if (strcasecmp(q->cond[i].property, property) == 0)
+                        return &q->cond[i];
+        return NULL;
+}
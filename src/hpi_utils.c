@@ -14,7 +14,52 @@
  *
  */
 
+#include <stdio.h>
+#include <pthread.h>
 #include <SaHpi.h>
+#include <oh_utils.h>
+#include <hpi_utils.h>
+
+struct hpi_handle hpi_hnd;
+
+static pthread_mutex_t hpi_hnd_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Open the session and discover the domain. Every provider calls this from
+ * its initialization; only the first successful call opens the session. */
+SaErrorT hpi_session_open(void)
+{
+        SaErrorT error = SA_OK;
+
+        pthread_mutex_lock(&hpi_hnd_lock);
+        if (hpi_hnd.sid) {
+                pthread_mutex_unlock(&hpi_hnd_lock);
+                return SA_OK;
+        }
+
+        error = saHpiSessionOpen(SAHPI_UNSPECIFIED_DOMAIN_ID, &(hpi_hnd.sid), 0);
+        if (error) {
+                hpi_hnd.sid = 0;
+                pthread_mutex_unlock(&hpi_hnd_lock);
+                return error;
+        }
+
+        error = saHpiDomainInfoGet(hpi_hnd.sid, &(hpi_hnd.domain_info));
+        if (error) {
+                saHpiSessionClose(hpi_hnd.sid);
+                hpi_hnd.sid = 0;
+                pthread_mutex_unlock(&hpi_hnd_lock);
+                return error;
+        }
+
+        /* Events let the inventory rescan only the resources involved. It
+           still works without them, from RptUpdateCount alone. */
+        saHpiSubscribe(hpi_hnd.sid);
+
+        error = saHpiDiscover(hpi_hnd.sid);
+
+        pthread_mutex_unlock(&hpi_hnd_lock);
+        return error;
+}
 
 int management_instrument_id(SaHpiRdrT  *rdr)
 {
@@ -45,4 +90,14 @@ int management_instrument_id(SaHpiRdrT  *rdr)
         return (-1);
 }
 
-
+/* Build the DeviceID key shared by every HPI_LogicalDevice instance */
+int hpi_device_id(char *buf, size_t len,
+                  SaHpiDomainIdT did,
+                  SaHpiResourceIdT rid,
+                  SaHpiRdrTypeT type,
+                  SaHpiInstrumentIdT num)
+{
+        return snprintf(buf, len,
+                        "{Domain ID=%d}{Resource ID=%d}{Management Instrument Type=%s}{Management Instrument ID=%d}",
+                        did, rid, oh_lookup_rdrtype(type), num);
+}
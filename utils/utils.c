@@ -19,12 +19,14 @@
 #include <string.h>
 #include <errno.h>
 #include <unistd.h>
+#include <ctype.h>
 
 /* Include required CMPI library headers */
 #include "cmpidt.h"
 #include "cmpift.h"
 #include "cmpimacs.h"
 #include "OSBase_Common.h"
+#include "utils.h"
 
 
 /* Compare two CIM data values to see if they are identical */
@@ -90,3 +92,230 @@ int _CMSameObject( CMPIObjectPath * object1, CMPIObjectPath * object2 )
 }
 
 
+
+/* ---------------------------------------------------------------------------
+ * OBJECT PATH FINGERPRINTS
+ * --------------------------------------------------------------------------- */
+
+#define FNV64_BASIS 14695981039346656037ULL
+#define FNV64_PRIME 1099511628211ULL
+
+static unsigned long long _fnv64( unsigned long long hash, const void * data, size_t len )
+{
+   const unsigned char * p = data;
+
+   while (len--) {
+      hash ^= *p++;
+      hash *= FNV64_PRIME;
+   }
+   return hash;
+}
+
+/* Spread the bits of a key hash before it is summed with the others */
+static unsigned long long _mix64( unsigned long long h )
+{
+   h ^= h >> 30; h *= 0xBF58476D1CE4E5B9ULL;
+   h ^= h >> 27; h *= 0x94D049BB133111EBULL;
+   h ^= h >> 31;
+   return h;
+}
+
+/* Hash one key: its lowercased name, its type and its value */
+static unsigned long long _CMKeyHash( const char * name, CMPIData key )
+{
+   unsigned long long hash = FNV64_BASIS;
+   unsigned long long bits;
+   unsigned char c;
+   const char * str;
+   double real;
+
+   for (; *name; name++) {
+      c = tolower((unsigned char)*name);
+      hash = _fnv64(hash, &c, 1);
+   }
+   hash = _fnv64(hash, &key.type, sizeof(key.type));
+
+   /* Normalize each value to the bytes that _CMSameValue() compares */
+   switch (key.type) {
+      case CMPI_string:
+         str = CMGetCharPtr(key.value.string);
+         return _fnv64(hash, str, strlen(str));
+      case CMPI_dateTime: bits = CMGetBinaryFormat(key.value.dateTime, NULL); break;
+      case CMPI_boolean:  bits = key.value.boolean; break;
+      case CMPI_char16:   bits = key.value.char16; break;
+      case CMPI_uint8:    bits = key.value.uint8; break;
+      case CMPI_sint8:    bits = key.value.sint8; break;
+      case CMPI_uint16:   bits = key.value.uint16; break;
+      case CMPI_sint16:   bits = key.value.sint16; break;
+      case CMPI_uint32:   bits = key.value.uint32; break;
+      case CMPI_sint32:   bits = key.value.sint32; break;
+      case CMPI_uint64:   bits = key.value.uint64; break;
+      case CMPI_sint64:   bits = key.value.sint64; break;
+      case CMPI_real32:
+      case CMPI_real64:
+         /* +0.0 and -0.0 compare equal */
+         real = (key.type == CMPI_real32) ? key.value.real32 : key.value.real64;
+         if (real == 0.0) real = 0.0;
+         memcpy(&bits, &real, sizeof(bits));
+         break;
+      default: bits = 0; break;
+   }
+   return _fnv64(hash, &bits, sizeof(bits));
+}
+
+
+/* Compute a 64-bit fingerprint of the keys of a CIM object path. Two paths
+   that _CMSameObject() considers the same have the same fingerprint, so
+   paths with different fingerprints never need to be compared key by key.
+   The key hashes are summed, which makes the result independent of the
+   key order without sorting the key names. */
+unsigned long long _CMObjectFingerprint( CMPIObjectPath * object )
+{
+   CMPIData key;
+   CMPIString * keyname = NULL;
+   unsigned long long hash = 0;
+   int numkeys, i;
+
+   numkeys = CMGetKeyCount(object, NULL);
+   for (i=0; i<numkeys; i++) {
+      key = CMGetKeyAt(object, i, &keyname, NULL);
+      if (CMIsNullValue(key)) continue;
+      hash += _mix64(_CMKeyHash(CMGetCharPtr(keyname), key));
+   }
+
+   return _mix64(hash ^ (unsigned long long)numkeys);
+}
+
+
+/* ---------------------------------------------------------------------------
+ * OBJECT PATH MAP
+ * --------------------------------------------------------------------------- */
+
+/* Open addressed hash map from object paths to caller data. The paths are
+   not copied, they must stay valid while they are in the map. */
+struct _CMObjectMap {
+   unsigned long long * hash;
+   CMPIObjectPath ** object;     /* NULL marks an empty slot */
+   void ** value;
+   unsigned int count;
+   unsigned int size;            /* power of two */
+};
+
+CMObjectMap * _CMNewObjectMap( void )
+{
+   return calloc(1, sizeof(CMObjectMap));
+}
+
+void _CMReleaseObjectMap( CMObjectMap * map )
+{
+   if (map == NULL) return;
+   free(map->hash);
+   free(map->object);
+   free(map->value);
+   free(map);
+}
+
+unsigned int _CMObjectMapCount( CMObjectMap * map )
+{
+   return map->count;
+}
+
+/* Find the slot of a path, or the empty slot where it would go */
+static unsigned int _CMObjectMapSlot( CMObjectMap * map, CMPIObjectPath * object, unsigned long long hash )
+{
+   unsigned int i;
+
+   for (i = hash & (map->size - 1); map->object[i] != NULL; i = (i + 1) & (map->size - 1)) {
+      /* Only a fingerprint match needs the full key comparison */
+      if (map->hash[i] == hash &&
+          (map->object[i] == object || _CMSameObject(map->object[i], object)))
+         break;
+   }
+   return i;
+}
+
+static int _CMObjectMapGrow( CMObjectMap * map )
+{
+   CMObjectMap bigger;
+   unsigned int i, j;
+
+   bigger.size = map->size ? map->size * 2 : 16;
+   bigger.count = map->count;
+   bigger.hash = malloc(bigger.size * sizeof(*bigger.hash));
+   bigger.object = calloc(bigger.size, sizeof(*bigger.object));
+   bigger.value = malloc(bigger.size * sizeof(*bigger.value));
+   if (bigger.hash == NULL || bigger.object == NULL || bigger.value == NULL) {
+      free(bigger.hash); free(bigger.object); free(bigger.value);
+      return -1;
+   }
+
+   /* Rehash from the stored fingerprints, no path is looked at again */
+   for (i=0; i<map->size; i++) {
+      if (map->object[i] == NULL) continue;
+      for (j = map->hash[i] & (bigger.size - 1); bigger.object[j] != NULL; j = (j + 1) & (bigger.size - 1));
+      bigger.hash[j] = map->hash[i];
+      bigger.object[j] = map->object[i];
+      bigger.value[j] = map->value[i];
+   }
+
+   free(map->hash); free(map->object); free(map->value);
+   *map = bigger;
+   return 0;
+}
+
+/* Add a path to the map. Returns 1 if it was added, 0 if the same object
+   was already in the map (its value is left alone) and -1 if out of memory. */
+int _CMObjectMapAdd( CMObjectMap * map, CMPIObjectPath * object, void * value )
+{
+   unsigned long long hash;
+   unsigned int i;
+
+   /* Keep the map at most three quarters full */
+   if ((map->count + 1) * 4 > map->size * 3 && _CMObjectMapGrow(map) != 0) return -1;
+
+   hash = _CMObjectFingerprint(object);
+   i = _CMObjectMapSlot(map, object, hash);
+   if (map->object[i] != NULL) return 0;
+
+   map->hash[i] = hash;
+   map->object[i] = object;
+   map->value[i] = value;
+   map->count++;
+   return 1;
+}
+
+/* Look up a path. Returns a pointer to its value, which may be updated in
+   place, or NULL if the same object is not in the map. */
+void ** _CMObjectMapFind( CMObjectMap * map, CMPIObjectPath * object )
+{
+   unsigned int i;
+
+   if (map->count == 0) return NULL;
+
+   i = _CMObjectMapSlot(map, object, _CMObjectFingerprint(object));
+   return (map->object[i] != NULL) ? &map->value[i] : NULL;
+}
+
+/* Remove a path. Returns 1 if it was in the map, 0 otherwise. */
+int _CMObjectMapRemove( CMObjectMap * map, CMPIObjectPath * object )
+{
+   unsigned int i, j, home;
+
+   if (map->count == 0) return 0;
+
+   i = _CMObjectMapSlot(map, object, _CMObjectFingerprint(object));
+   if (map->object[i] == NULL) return 0;
+
+   /* Shift later entries of the probe run back over the hole */
+   for (j = (i + 1) & (map->size - 1); map->object[j] != NULL; j = (j + 1) & (map->size - 1)) {
+      home = map->hash[j] & (map->size - 1);
+      if (((j - home) & (map->size - 1)) < ((j - i) & (map->size - 1))) continue;
+      map->hash[i] = map->hash[j];
+      map->object[i] = map->object[j];
+      map->value[i] = map->value[j];
+      i = j;
+   }
+   map->object[i] = NULL;
+   map->count--;
+   return 1;
+}
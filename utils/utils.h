@@ -1,5 +1,22 @@
+#ifndef _UTILS_H_
+#define _UTILS_H_
+
 #include "cmpidt.h"
 
 int _CMSameValue( CMPIData value1, CMPIData value2 );
 int _CMSameObject( CMPIObjectPath * object1, CMPIObjectPath * object2 );
 
+/* 64-bit hash of the keys of an object path, equal for the same object */
+unsigned long long _CMObjectFingerprint( CMPIObjectPath * object );
+
+/* Hash map from object paths to caller data, by fingerprint */
+typedef struct _CMObjectMap CMObjectMap;
+
+CMObjectMap * _CMNewObjectMap( void );
+void _CMReleaseObjectMap( CMObjectMap * map );
+unsigned int _CMObjectMapCount( CMObjectMap * map );
+int _CMObjectMapAdd( CMObjectMap * map, CMPIObjectPath * object, void * value );
+void ** _CMObjectMapFind( CMObjectMap * map, CMPIObjectPath * object );
+int _CMObjectMapRemove( CMObjectMap * map, CMPIObjectPath * object );
+
+#endif /* _UTILS_H_ */